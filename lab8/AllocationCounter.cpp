@@ -0,0 +1,54 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+// count in debug builds too (the builds that run asserts), not only in the tests
+#if !defined(NDEBUG) && !defined(TETRIS_COUNT_ALLOCATIONS)
+#define TETRIS_COUNT_ALLOCATIONS
+#endif
+
+#ifdef TETRIS_COUNT_ALLOCATIONS
+
+// allocations made by each thread (a plain counter: no locking needed)
+static thread_local long long allocationCount = 0;
+
+// replacement global allocation functions (the array forms call these)
+void* operator new(std::size_t size) {
+	allocationCount++;
+	if (void* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+// return true if allocations are being counted in this build
+bool AllocationCounter::isEnabled() {
+	return true;
+}
+
+// return the # of allocations made by the calling thread so far
+long long AllocationCounter::getCount() {
+	return allocationCount;
+}
+
+#else
+
+// return true if allocations are being counted in this build
+bool AllocationCounter::isEnabled() {
+	return false;
+}
+
+// return the # of allocations made by the calling thread so far
+long long AllocationCounter::getCount() {
+	return 0;
+}
+
+#endif
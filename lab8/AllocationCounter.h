@@ -0,0 +1,22 @@
+// Counts heap allocations (calls to the global operator new) made by the
+// current thread, so tests can verify that hot paths never allocate.
+//
+// Counting replaces the global operator new/delete (see AllocationCounter.cpp),
+// and is only compiled in with TETRIS_COUNT_ALLOCATIONS defined - which the test
+// build always defines (the tests keep their asserts in every configuration), as
+// does any debug build. Otherwise isEnabled() returns false and getCount() is always 0.
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+class AllocationCounter
+{
+public:
+	// return true if allocations are being counted in this build
+	static bool isEnabled();
+
+	// return the # of allocations made by the calling thread so far
+	static long long getCount();
+};
+
+#endif /* ALLOCATIONCOUNTER_H */
@@ -0,0 +1,145 @@
+// tetris_batch: play a batch of games headlessly & print a throughput report.
+//
+//   tetris_batch [--games N] [--seed S] [--policy random|greedy|beam|scripted]
+//                [--script LETTERS] [--pieces MAX_PER_GAME]
+//                [--threads N] [--scaling] [--table MB]
+//
+// The same arguments always play the same games (see BatchRunner), on any # of threads.
+// --scaling plays the batch on 1, 2, 4 .. N threads & reports the speedup over 1 thread.
+// --table shares one transposition table of MB megabytes between the beam searches of
+// every thread & reports its counters & occupancy (to size it against a memory budget).
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BatchRunner.h"
+#include "SimulationPool.h"
+#include "TranspositionTable.h"
+
+// print the command line usage
+static void printUsage() {
+	std::cerr << "usage: tetris_batch [--games N] [--seed S] [--policy random|greedy|beam|scripted]\n"
+		<< "                    [--script LETTERS] [--pieces MAX_PER_GAME]\n"
+		<< "                    [--threads N] [--scaling] [--table MB]\n"
+		<< "  threads: 0 = one per hardware thread (the default)\n"
+		<< "  table: a transposition table shared by the beam policy's searches\n"
+		<< "  script letters: L left, R right, D soft drop, H hard drop,\n"
+		<< "                  X rotate CW, Z rotate CCW, A rotate 180, C hold\n";
+}
+
+// print the counters & occupancy of a transposition table
+static void printTableReport(std::ostream& out, const TranspositionTable& table) {
+	TranspositionStats stats = table.getStats();
+	std::uint64_t probes = stats.hits + stats.misses;
+	out << "table: " << table.getSizeBytes() / (1024 * 1024.0) << " MB  slots: " << table.getSlotCount()
+		<< "  occupancy: " << 100.0 * table.getOccupancy() << "%\n"
+		<< "  probes: " << probes << "  hits: " << stats.hits
+		<< " (" << (probes > 0 ? 100.0 * stats.hits / probes : 0.0) << "%)  misses: " << stats.misses
+		<< "  stores: " << stats.stores << "  collisions: " << stats.collisions
+		<< "  rejected: " << stats.rejected << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+	int games = 100;
+	std::uint64_t seed = 1;
+	std::string policyName = "greedy";
+	std::string script = "LXH";
+	int maxPieces = BatchRunner::DEFAULT_MAX_PIECES;
+	int threads = 0;
+	bool scaling = false;
+	int tableMegabytes = 0;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--games") == 0 && hasValue) {
+			games = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--policy") == 0 && hasValue) {
+			policyName = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--script") == 0 && hasValue) {
+			script = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--pieces") == 0 && hasValue) {
+			maxPieces = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--scaling") == 0) {
+			scaling = true;
+		}
+		else if (std::strcmp(argv[i], "--table") == 0 && hasValue) {
+			tableMegabytes = std::atoi(argv[++i]);
+		}
+		else {
+			printUsage();
+			return 2;
+		}
+	}
+
+	std::unique_ptr<GamePolicy> policy = GamePolicy::create(policyName, script);
+	if (!policy || games < 1 || maxPieces < 1 || threads < 0 || tableMegabytes < 0
+		|| (tableMegabytes > 0 && policyName != "beam")) {
+		printUsage();
+		return 2;
+	}
+	std::unique_ptr<TranspositionTable> table;
+	if (tableMegabytes > 0) {
+		table.reset(new TranspositionTable(static_cast<std::size_t>(tableMegabytes) * 1024 * 1024));
+	}
+	SimulationPool::PolicyFactory makePolicy = [&policyName, &script, &table]() {
+		if (table) {
+			return std::unique_ptr<GamePolicy>(new BeamSearchPolicy(BeamSearch::DEFAULT_BEAM_WIDTH,
+				BeamSearch::DEFAULT_DEPTH, 0, table.get()));
+		}
+		return GamePolicy::create(policyName, script);
+	};
+	int maxThreads = SimulationPool::resolveThreadCount(threads);
+
+	std::cout << "policy: " << policy->getName() << "  seed: " << seed << "  max pieces/game: " << maxPieces << "\n";
+	if (!scaling) {
+		SimulationPool pool(maxThreads, maxPieces);
+		BatchResult result = pool.run(seed, games, makePolicy);
+		std::cout << "threads: " << maxThreads << "  steals: " << pool.getStealCount() << "\n";
+		BatchRunner::printReport(std::cout, result);
+		if (table) {
+			printTableReport(std::cout, *table);
+		}
+		return 0;
+	}
+
+	// the scaling benchmark: the same batch on 1, 2, 4 .. maxThreads threads
+	std::vector<int> threadCounts;
+	for (int n = 1; n < maxThreads; n *= 2) {
+		threadCounts.push_back(n);
+	}
+	threadCounts.push_back(maxThreads);
+	double baseGamesPerSec = 0.0;
+	for (int n : threadCounts) {
+		if (table) {
+			table->clear();
+			table->resetStats();
+		}
+		SimulationPool pool(n, maxPieces);
+		BatchResult result = pool.run(seed, games, makePolicy);
+		double gamesPerSec = result.games / (result.seconds > 0.0 ? result.seconds : 1e-9);
+		if (n == 1) {
+			baseGamesPerSec = gamesPerSec;
+		}
+		std::cout << "threads: " << n << "  games/sec: " << gamesPerSec
+			<< "  pieces/sec: " << result.pieces / (result.seconds > 0.0 ? result.seconds : 1e-9)
+			<< "  speedup: " << gamesPerSec / baseGamesPerSec
+			<< "  steals: " << pool.getStealCount() << "\n";
+		if (table) {
+			printTableReport(std::cout, *table);
+		}
+	}
+	return 0;
+}
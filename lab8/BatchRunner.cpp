@@ -0,0 +1,96 @@
+#include <chrono>
+#include <iomanip>
+#include "BatchRunner.h"
+
+// add one game's result
+void BatchResult::add(const GameResult& game) {
+	games++;
+	pieces += static_cast<std::uint64_t>(game.pieces);
+	rows += static_cast<std::uint64_t>(game.rows);
+	score += static_cast<std::uint64_t>(game.score);
+	toppedOut += game.toppedOut ? 1 : 0;
+}
+
+// add the totals of another batch (its time runs in parallel: the longest counts)
+void BatchResult::merge(const BatchResult& other) {
+	games += other.games;
+	pieces += other.pieces;
+	rows += other.rows;
+	score += other.score;
+	toppedOut += other.toppedOut;
+	seconds = seconds > other.seconds ? seconds : other.seconds;
+	pieceLatency.merge(other.pieceLatency);
+}
+
+// constructor, end each game after maxPiecesPerGame shapes (if it hasn't topped out)
+BatchRunner::BatchRunner(int maxPiecesPerGame) {
+	this->maxPiecesPerGame = maxPiecesPerGame;
+}
+
+// return the seed of game # game of the batch seeded with masterSeed
+std::uint64_t BatchRunner::getGameSeed(std::uint64_t masterSeed, std::uint64_t game) {
+	return PieceGenerator::random(masterSeed, game);
+}
+
+// play one game from seed with policy (reset for the game first) & return its result
+//   record each shape's latency in pieceLatency (if it isn't null)
+GameResult BatchRunner::playGame(std::uint64_t seed, GamePolicy& policy, LatencyHistogram* pieceLatency) const {
+	typedef std::chrono::steady_clock Clock;
+	TetrisSimulation game(seed);
+	policy.reset(seed);
+
+	Clock::time_point start = Clock::now();
+	while (!game.isGameOver() && game.getPiecesLocked() < maxPiecesPerGame) {
+		int piece = game.getPiecesLocked();
+		for (int actions = 0; game.getPiecesLocked() == piece && !game.isGameOver(); actions++) {
+			game.applyAction(actions < MAX_ACTIONS_PER_PIECE ? policy.nextAction(game) : ACTION_HARD_DROP);
+		}
+		if (pieceLatency) {
+			Clock::time_point end = Clock::now();
+			pieceLatency->record(static_cast<std::uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+			start = end;
+		}
+	}
+
+	GameResult result;
+	result.seed = seed;
+	result.pieces = game.getPiecesLocked();
+	result.rows = game.getRowsCleared();
+	result.score = game.getScore();
+	result.toppedOut = game.isGameOver();
+	return result;
+}
+
+// play games firstGame .. firstGame + count - 1 of the batch seeded with masterSeed
+BatchResult BatchRunner::run(std::uint64_t masterSeed, std::uint64_t firstGame, int count, GamePolicy& policy) const {
+	typedef std::chrono::steady_clock Clock;
+	BatchResult result;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < count; i++) {
+		result.add(playGame(getGameSeed(masterSeed, firstGame + i), policy, &result.pieceLatency));
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return result;
+}
+
+// print a throughput report for result (games/sec, pieces/sec, lines/sec, latencies)
+void BatchRunner::printReport(std::ostream& out, const BatchResult& result) {
+	double seconds = result.seconds > 0.0 ? result.seconds : 1e-9;
+	std::ios::fmtflags flags = out.flags();
+	out << std::fixed << std::setprecision(1);
+	out << "games: " << result.games << "  pieces: " << result.pieces << "  lines: " << result.rows
+		<< "  topped out: " << result.toppedOut << "  time: " << std::setprecision(3) << result.seconds << " s\n";
+	out << std::setprecision(1);
+	out << "games/sec: " << result.games / seconds
+		<< "  pieces/sec: " << result.pieces / seconds
+		<< "  lines/sec: " << result.rows / seconds << "\n";
+	const LatencyHistogram& latency = result.pieceLatency;
+	out << "piece latency (ns):  mean " << latency.getMean()
+		<< "  p50 " << latency.getPercentile(50)
+		<< "  p90 " << latency.getPercentile(90)
+		<< "  p99 " << latency.getPercentile(99)
+		<< "  p99.9 " << latency.getPercentile(99.9)
+		<< "  max " << latency.getMax() << "\n";
+	out.flags(flags);
+}
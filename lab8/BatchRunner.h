@@ -0,0 +1,72 @@
+// The BatchRunner plays whole games headlessly, as fast as the CPU allows (no window,
+// no clock, no sleeping), and measures them: games, shapes & rows per second, and
+// the latency of each shape (the policy's decisions + the simulation's moves).
+// It is the engine's throughput benchmark (see BatchMain.cpp for the command line tool).
+//
+// Each game is seeded from a master seed & its game #, so a batch - or any single
+// game in it - can be replayed exactly.
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <cstdint>
+#include <ostream>
+#include "GamePolicy.h"
+#include "LatencyHistogram.h"
+
+// the outcome of one game
+struct GameResult
+{
+	std::uint64_t seed = 0;		// the seed it was played with
+	int pieces = 0;				// the # of shapes locked
+	int rows = 0;				// the # of rows cleared
+	int score = 0;				// the final score
+	bool toppedOut = false;		// true if it ended in a game over (false: it hit the piece limit)
+};
+
+// the totals of a batch of games
+struct BatchResult
+{
+	int games = 0;
+	std::uint64_t pieces = 0;
+	std::uint64_t rows = 0;
+	std::uint64_t score = 0;
+	int toppedOut = 0;
+	double seconds = 0.0;				// wall clock time (for the per second rates)
+	LatencyHistogram pieceLatency;		// nanoseconds per shape
+
+	// add one game's result
+	void add(const GameResult& game);
+	// add the totals of another batch (its time runs in parallel: the longest counts)
+	void merge(const BatchResult& other);
+};
+
+class BatchRunner
+{
+public:
+	static const int DEFAULT_MAX_PIECES = 1000;		// a game ends after this many shapes
+	static const int MAX_ACTIONS_PER_PIECE = 256;	// a shape is hard dropped after this many actions
+
+	// constructor, end each game after maxPiecesPerGame shapes (if it hasn't topped out)
+	BatchRunner(int maxPiecesPerGame = DEFAULT_MAX_PIECES);
+
+	// return the seed of game # game of the batch seeded with masterSeed
+	static std::uint64_t getGameSeed(std::uint64_t masterSeed, std::uint64_t game);
+
+	// play one game from seed with policy (reset for the game first) & return its result
+	//   record each shape's latency in pieceLatency (if it isn't null)
+	GameResult playGame(std::uint64_t seed, GamePolicy& policy, LatencyHistogram* pieceLatency = nullptr) const;
+
+	// play games firstGame .. firstGame + count - 1 of the batch seeded with masterSeed
+	BatchResult run(std::uint64_t masterSeed, std::uint64_t firstGame, int count, GamePolicy& policy) const;
+
+	// print a throughput report for result (games/sec, pieces/sec, lines/sec, latencies)
+	static void printReport(std::ostream& out, const BatchResult& result);
+
+private:
+	int maxPiecesPerGame;	// a game ends after this many shapes
+};
+
+#endif /* BATCHRUNNER_H */
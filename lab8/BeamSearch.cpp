@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include "BeamSearch.h"
+
+const int BeamSearch::DEFAULT_BEAM_WIDTH;
+const int BeamSearch::DEFAULT_DEPTH;
+
+// return the steady clock time, in microseconds
+static std::int64_t getMicros() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// constructor, keeping beamWidth boards per depth, searching depth shapes deep
+//   (the current shape & depth - 1 preview shapes) within timeBudgetMicros (0 = no limit)
+BeamSearch::BeamSearch(int beamWidth, int depth, std::int64_t timeBudgetMicros, const EvaluatorWeights& weights)
+	: evaluator(weights) {
+	setBeamWidth(beamWidth);
+	setDepth(depth);
+	setTimeBudget(timeBudgetMicros);
+	bestPath.reserve(64);
+}
+
+// getters & setters for the settings
+int BeamSearch::getBeamWidth() const {
+	return beamWidth;
+}
+
+void BeamSearch::setBeamWidth(int beamWidth) {
+	assert(beamWidth >= 1);
+	this->beamWidth = std::max(beamWidth, 1);
+}
+
+int BeamSearch::getDepth() const {
+	return depth;
+}
+
+void BeamSearch::setDepth(int depth) {
+	assert(depth >= 1);
+	this->depth = std::max(depth, 1);
+}
+
+std::int64_t BeamSearch::getTimeBudget() const {
+	return timeBudgetMicros;
+}
+
+void BeamSearch::setTimeBudget(std::int64_t timeBudgetMicros) {
+	this->timeBudgetMicros = std::max<std::int64_t>(timeBudgetMicros, 0);
+}
+
+// getter & setter for the transposition table to share (nullptr = none: it isn't owned)
+TranspositionTable* BeamSearch::getTranspositionTable() const {
+	return table;
+}
+
+void BeamSearch::setTranspositionTable(TranspositionTable* table) {
+	this->table = table;
+}
+
+// search for the best placement of game's current shape (from where it is now)
+//   return false if it has none (it doesn't fit, or every placement locks out)
+//   Depth by depth from the game's board: expand every board of the beam with the
+//   depth's shape (the current shape where it is, then each preview shape at the spawn
+//   loc), and keep the best distinct boards as the next beam. A node's score is the
+//   evaluator's score of its board plus the row clearing score of the placements above
+//   it, so clearing rows early isn't forgotten by the boards below. The search stops
+//   at the last shape (or the last one the preview shows), when the time runs out (the
+//   unfinished depth is dropped), or when every placement of a depth locks out.
+//   The best node left names the root placement, which is regenerated for its path.
+bool BeamSearch::search(const TetrisSimulation& game) {
+	std::int64_t start = getMicros();
+	arena.reset();
+	deadline = 0;
+	depthReached = 0;
+	nodesExpanded = 0;
+	lastBeamSize = 0;
+
+	const PieceQueue& queue = game.getPieceQueue();
+	int maxDepth = std::min(depth, 1 + queue.getPreviewSize());
+
+	Node* beam = arena.allocate<Node>(1);
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		beam[0].rows[y] = game.getBoard().getRowMask(y);
+	}
+	beam[0].score = 0.0;
+	beam[0].rowBonus = 0.0;
+	beam[0].root = -1;
+	int beamSize = 1;
+
+	GridTetromino shape = game.getCurrentShape();
+	for (int d = 0; d < maxDepth; d++) {
+		if (d > 0) {
+			shape.setShape(queue.peek(d - 1));
+			shape.setRotation(0);
+			shape.setGridLoc(game.getBoard().getSpawnLoc());
+		}
+		Candidate* candidates = nullptr;
+		int count = expandBeam(beam, beamSize, shape, d > 0 && d == maxDepth - 1, candidates);
+		if (count < 0) {
+			break;
+		}
+		Node* next = arena.allocate<Node>(static_cast<std::size_t>(beamWidth));
+		int kept = selectBeam(beam, candidates, count, next);
+		if (kept == 0) {
+			break;
+		}
+		beam = next;
+		beamSize = kept;
+		depthReached = d + 1;
+		if (d == 0 && timeBudgetMicros > 0) {
+			deadline = start + timeBudgetMicros;
+		}
+	}
+	if (depthReached == 0) {
+		return false;
+	}
+	lastBeamSize = beamSize;
+	bestScore = beam[0].score;
+
+	int root = beam[0].root;
+	generator.generate(game.getBoard(), game.getCurrentShape());
+	assert(root >= 0 && root < generator.getPlacementCount());
+	bestPlacement = generator.getPlacement(root).piece;
+	const InputAction* path = generator.getPath(root);
+	bestPath.assign(path, path + generator.getPlacement(root).pathLength);
+	return true;
+}
+
+// the results of the last successful search()
+PackedPiece BeamSearch::getBestPlacement() const {
+	return bestPlacement;
+}
+
+const InputAction* BeamSearch::getBestPath() const {
+	return bestPath.data();
+}
+
+int BeamSearch::getBestPathLength() const {
+	return static_cast<int>(bestPath.size());
+}
+
+double BeamSearch::getBestScore() const {
+	return bestScore;
+}
+
+int BeamSearch::getDepthReached() const {
+	return depthReached;
+}
+
+int BeamSearch::getNodesExpanded() const {
+	return nodesExpanded;
+}
+
+int BeamSearch::getLastBeamSize() const {
+	return lastBeamSize;
+}
+
+// expand the beam (beamSize nodes) with shape: point candidates at all of their
+//   placements, return their #, or -1 if the time budget ran out (see search())
+//   (last: shape is the last depth's, spawned - only its best placements count)
+//   Each node's placements are scored in one call to the evaluator, into arrays of
+//   their own (the # of placements isn't known before generating them), then gathered
+//   into one array for selectBeam().
+//   At the last depth, with a table, each node has one candidate: its best placement,
+//   from the table if its board & shape are in it (searched 1 shape deep), else found
+//   (the first of the best score, as selectBeam() sorts them) & stored. Its score is the
+//   stored one (a float) either way, so a hit chooses exactly as a miss would: a search
+//   is the same whichever other searches share the table.
+int BeamSearch::expandBeam(const Node* beam, int beamSize, const GridTetromino& shape, bool last, Candidate*& candidates) {
+	Candidate** lists = arena.allocate<Candidate*>(static_cast<std::size_t>(beamSize));
+	int* counts = arena.allocate<int>(static_cast<std::size_t>(beamSize));
+	int total = 0;
+	bool useTable = last && table;
+	for (int i = 0; i < beamSize; i++) {
+		if (isOutOfTime()) {
+			return -1;
+		}
+		std::uint64_t key = 0;
+		TranspositionEntry entry;
+		bool cached = false;	// true once entry holds the node's best placement
+		if (useTable) {
+			key = TranspositionTable::getKey(Gameboard::getOccupancyHash(beam[i].rows), shape.getShape());
+			cached = table->probe(key, entry) && entry.depth >= 1;
+		}
+		int count = 0;
+		PackedPiece* pieces = nullptr;
+		double* scores = nullptr;
+		if (!cached) {
+			count = generator.generate(beam[i].rows, shape);
+			nodesExpanded++;
+			pieces = arena.allocate<PackedPiece>(static_cast<std::size_t>(count));
+			scores = arena.allocate<double>(static_cast<std::size_t>(count));
+			for (int p = 0; p < count; p++) {
+				pieces[p] = generator.getPlacement(p).piece;
+			}
+			evaluator.evaluatePlacements(beam[i].rows, pieces, count, scores);
+		}
+		if (useTable && !cached && count > 0) {
+			int best = 0;
+			for (int p = 1; p < count; p++) {
+				best = (scores[p] > scores[best]) ? p : best;
+			}
+			entry.score = static_cast<float>(scores[best]);
+			entry.depth = 1;
+			entry.best = pieces[best];
+			table->store(key, entry);
+			cached = true;
+		}
+
+		Candidate* list = nullptr;
+		if (useTable) {
+			count = cached ? 1 : 0;
+			list = arena.allocate<Candidate>(static_cast<std::size_t>(count));
+			if (cached) {
+				list[0].score = entry.score + beam[i].rowBonus;
+				list[0].parent = i;
+				list[0].placement = 0;
+				list[0].piece = entry.best;
+			}
+		}
+		else {
+			list = arena.allocate<Candidate>(static_cast<std::size_t>(count));
+			for (int p = 0; p < count; p++) {
+				list[p].score = scores[p] + beam[i].rowBonus;
+				list[p].parent = i;
+				list[p].placement = p;
+				list[p].piece = pieces[p];
+			}
+		}
+		lists[i] = list;
+		counts[i] = count;
+		total += count;
+	}
+
+	candidates = arena.allocate<Candidate>(static_cast<std::size_t>(total));
+	Candidate* end = candidates;
+	for (int i = 0; i < beamSize; i++) {
+		end = std::copy(lists[i], lists[i] + counts[i], end);
+	}
+	return total;
+}
+
+// fill next (up to beamWidth nodes) with the best distinct boards of the candidates
+//   of beam, return the # kept
+//   The candidates are sorted best first and locked in that order: a board already
+//   kept (by its hash, in an open addressing set) was reached by a better candidate,
+//   so the later one is dropped. Locked out candidates (-infinity) sort last.
+//   (std::sort, not std::stable_sort: it sorts in place, without a buffer)
+int BeamSearch::selectBeam(const Node* beam, Candidate* candidates, int count, Node* next) {
+	std::sort(candidates, candidates + count, [](const Candidate& a, const Candidate& b) {
+		return a.score > b.score || (a.score == b.score && (a.parent < b.parent
+			|| (a.parent == b.parent && a.placement < b.placement)));
+	});
+
+	std::size_t slots = 2 * static_cast<std::size_t>(std::min(beamWidth, count));
+	std::size_t mask = 1;
+	while (mask < slots) {
+		mask <<= 1;
+	}
+	std::uint64_t* seen = arena.allocate<std::uint64_t>(mask);	// 0 = empty, else hash | 1
+	std::memset(seen, 0, mask * sizeof(std::uint64_t));
+	mask--;
+
+	const double lockedOut = -std::numeric_limits<double>::infinity();
+	int kept = 0;
+	for (int c = 0; c < count && kept < beamWidth && candidates[c].score != lockedOut; c++) {
+		const Candidate& candidate = candidates[c];
+		const Node& parent = beam[candidate.parent];
+		Node& child = next[kept];
+		int cleared = BoardEvaluator::lockPiece(parent.rows, candidate.piece, child.rows);
+		assert(cleared >= 0);
+
+		std::uint64_t hash = Gameboard::getOccupancyHash(child.rows) | 1;
+		std::size_t slot = static_cast<std::size_t>(hash) & mask;
+		while (seen[slot] != 0 && seen[slot] != hash) {
+			slot = (slot + 1) & mask;
+		}
+		if (seen[slot] == hash) {
+			continue;
+		}
+		seen[slot] = hash;
+		child.score = candidate.score;
+		child.rowBonus = parent.rowBonus + evaluator.getWeights().rowsCleared * cleared;
+		child.root = (parent.root < 0) ? candidate.placement : parent.root;
+		kept++;
+	}
+	return kept;
+}
+
+// return true if the time budget of the current search has run out
+//   (never before the first depth is done: the deadline is set after it)
+bool BeamSearch::isOutOfTime() const {
+	return deadline > 0 && getMicros() >= deadline;
+}
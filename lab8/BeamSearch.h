@@ -0,0 +1,128 @@
+// BeamSearch chooses where to put the current shape by looking ahead at the shapes
+// the preview shows, rather than at the current shape alone (as GreedyPolicy does).
+// Functionality:
+//  - Depth 1 places the current shape in every way the MoveGenerator finds, depth 2
+//    places the first preview shape on each of the resulting boards, and so on (up to
+//    the preview size). No hold.
+//  - Every child board is scored by the BoardEvaluator (plus the row clearing bonus of
+//    the placements above it), and only the beamWidth best distinct boards of a depth
+//    are kept & expanded: boards reached twice (by board hash) are kept once.
+//  - The best board of the deepest depth searched decides the placement of the current
+//    shape - the root placement it descends from - and its input path.
+//  - Every node, candidate list & score array of a search comes from a SearchArena that
+//    is reset per search: once the arena (and the move generator's lists) have grown to
+//    the size a search needs, searching does no heap allocation at all.
+//  - A time budget (0 = none) stops the search between node expansions once it runs
+//    out; the last depth searched in full decides. Depth 1 is always searched in full.
+//  - A TranspositionTable (optional, & shared by any # of searches on any # of threads)
+//    remembers the best placement of the last depth's shape on each board of the last
+//    beam but one: found there again, the board isn't expanded. With a table, each of
+//    those boards adds only its best placement to the last beam (the same decision: only
+//    the best board of the last beam counts). Positions come up again in searches of the
+//    same position (a re-search, other threads, other games), rarely within one game:
+//    every board of a depth is distinct already.
+//
+//  [expected .cpp size: ~ 300 lines]
+
+#ifndef BEAMSEARCH_H
+#define BEAMSEARCH_H
+
+#include <cstdint>
+#include <vector>
+#include "BoardEvaluator.h"
+#include "MoveGenerator.h"
+#include "SearchArena.h"
+#include "TetrisSimulation.h"
+#include "TranspositionTable.h"
+
+class BeamSearch
+{
+public:
+	static const int DEFAULT_BEAM_WIDTH = 32;
+	static const int DEFAULT_DEPTH = 2;		// the current shape & the first preview shape
+
+	// constructor, keeping beamWidth boards per depth, searching depth shapes deep
+	//   (the current shape & depth - 1 preview shapes) within timeBudgetMicros (0 = no limit)
+	BeamSearch(int beamWidth = DEFAULT_BEAM_WIDTH, int depth = DEFAULT_DEPTH,
+		std::int64_t timeBudgetMicros = 0, const EvaluatorWeights& weights = EvaluatorWeights());
+
+	// getters & setters for the settings
+	int getBeamWidth() const;
+	void setBeamWidth(int beamWidth);
+	int getDepth() const;
+	void setDepth(int depth);
+	std::int64_t getTimeBudget() const;
+	void setTimeBudget(std::int64_t timeBudgetMicros);
+	// getter & setter for the transposition table to share (nullptr = none: it isn't owned)
+	TranspositionTable* getTranspositionTable() const;
+	void setTranspositionTable(TranspositionTable* table);
+
+	// search for the best placement of game's current shape (from where it is now)
+	//   return false if it has none (it doesn't fit, or every placement locks out)
+	bool search(const TetrisSimulation& game);
+
+	// the results of the last successful search():
+	//   the best placement, its input path (getBestPathLength() actions, ending with a
+	//   hard drop) and its score (the score of the best board it leads to)
+	PackedPiece getBestPlacement() const;
+	const InputAction* getBestPath() const;
+	int getBestPathLength() const;
+	double getBestScore() const;
+	// the # of depths searched in full, boards expanded, and distinct boards in the last beam
+	int getDepthReached() const;
+	int getNodesExpanded() const;
+	int getLastBeamSize() const;
+
+private:
+	// a board in the beam
+	struct Node
+	{
+		Gameboard::RowMask rows[Gameboard::MAX_Y];	// the board
+		double score;								// its score (see search())
+		double rowBonus;							// the row clearing score of the placements to it
+		int root;									// the root placement it descends from
+	};
+	// a placement on a board of the beam
+	struct Candidate
+	{
+		double score;		// the score of the board it leaves
+		int parent;			// the index of the board in the beam
+		int placement;		// its # in the move generator's list (of the parent's board)
+		PackedPiece piece;	// the placement
+	};
+
+	// expand the beam (beamSize nodes) with shape: point candidates at all of their
+	//   placements, return their #, or -1 if the time budget ran out (see search())
+	//   (last: shape is the last depth's, spawned - only its best placements count)
+	int expandBeam(const Node* beam, int beamSize, const GridTetromino& shape, bool last, Candidate*& candidates);
+	// fill next (up to beamWidth nodes) with the best distinct boards of the candidates
+	//   of beam, return the # kept
+	int selectBeam(const Node* beam, Candidate* candidates, int count, Node* next);
+
+	// return true if the time budget of the current search has run out
+	bool isOutOfTime() const;
+
+	// MEMBER VARIABLES
+	int beamWidth;						// the # of boards kept per depth
+	int depth;							// the # of shapes searched
+	std::int64_t timeBudgetMicros;		// the time per search (0 = no limit)
+	TranspositionTable* table = nullptr;	// the shared table (or none)
+
+	MoveGenerator generator;			// finds the placements
+	BoardEvaluator evaluator;			// scores them
+	SearchArena arena;					// the memory of one search
+	std::int64_t deadline = 0;			// the steady clock time (in microseconds) to stop at
+
+	PackedPiece bestPlacement = {};		// the results of the last search
+	std::vector<InputAction> bestPath;
+	double bestScore = 0.0;
+	int depthReached = 0;
+	int nodesExpanded = 0;
+	int lastBeamSize = 0;
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* BEAMSEARCH_H */
@@ -0,0 +1,10 @@
+// tetris_bench: run the BenchmarkSuite on its own - no window, no SFML - against the
+// headless simulation core. Build in Release for meaningful numbers.
+
+#include "BenchmarkSuite.h"
+
+int main()
+{
+	BenchmarkSuite::runBenchmarks();
+	return 0;
+}
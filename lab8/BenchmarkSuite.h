@@ -0,0 +1,176 @@
+#ifndef BENCHMARKSUITE_H
+#define BENCHMARKSUITE_H
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include "Point.h"
+#include "Gameboard.h"
+#include "MoveGenerator.h"
+#include "BoardEvaluator.h"
+
+// Micro benchmarks for the hot gameboard operations.
+// Each workload is run for a fixed number of iterations and reported in
+// nanoseconds per operation. Meant to be run by hand (tetris_bench, see
+// BenchMain.cpp) when changing the board internals.
+class BenchmarkSuite
+{
+public:
+	static const int ITERATIONS = 2000000;
+
+	static void runBenchmarks()
+	{
+		std::cout << "Running BenchmarkSuite -------------------" << "\n";
+		BenchmarkSuite::benchmarkEmpty();
+		BenchmarkSuite::benchmarkClear();
+		BenchmarkSuite::benchmarkCollision();
+		BenchmarkSuite::benchmarkCollisionInPlace();
+		BenchmarkSuite::benchmarkFits();
+		BenchmarkSuite::benchmarkEvaluate();
+		std::cout << "BenchmarkSuite complete ------------------" << "\n";
+	}
+
+	// empty() a board over and over
+	static void benchmarkEmpty()
+	{
+		Gameboard g;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; i++) {
+			g.setContent(i % Gameboard::MAX_X, i % Gameboard::MAX_Y, 1);
+			g.empty();
+		}
+		report("empty", start, ITERATIONS, g.getContent(0, 0));
+	}
+
+	// fill the bottom 8 rows (every other one completed) & clear them
+	static void benchmarkClear()
+	{
+		Gameboard g;
+		long long sink = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS / 10; i++) {
+			for (int y = Gameboard::MAX_Y - 8; y < Gameboard::MAX_Y; y++) {
+				for (int x = 0; x < Gameboard::MAX_X; x++) {
+					g.setContent(x, y, y % 7);
+				}
+				if (y % 2 == 0) {
+					g.setContent(i % Gameboard::MAX_X, y, Gameboard::EMPTY_BLOCK);
+				}
+			}
+			sink += g.removeCompletedRows();
+		}
+		report("clear", start, ITERATIONS / 10, sink);
+	}
+
+	// sweep a 4 block shape over a half filled board with areLocsEmpty()
+	static void benchmarkCollision()
+	{
+		Gameboard g;
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if ((x + y) % 3 != 0) {
+					g.setContent(x, y, 1);
+				}
+			}
+		}
+		std::vector<Point> locs(4);
+		long long sink = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; i++) {
+			int x = i % (Gameboard::MAX_X - 1);
+			int y = i % (Gameboard::MAX_Y - 1);
+			locs[0].setXY(x, y);
+			locs[1].setXY(x + 1, y);
+			locs[2].setXY(x, y + 1);
+			locs[3].setXY(x + 1, y + 1);
+			sink += g.areLocsEmpty(locs);
+		}
+		report("collision", start, ITERATIONS, sink);
+	}
+
+	// the same sweep with the in place (locs + offset) areLocsEmpty()
+	static void benchmarkCollisionInPlace()
+	{
+		Gameboard g;
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if ((x + y) % 3 != 0) {
+					g.setContent(x, y, 1);
+				}
+			}
+		}
+		const std::array<Point, 4> locs = { Point(0, 0), Point(1, 0), Point(0, 1), Point(1, 1) };
+		long long sink = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; i++) {
+			sink += g.areLocsEmpty(locs, Point(i % (Gameboard::MAX_X - 1), i % (Gameboard::MAX_Y - 1)));
+		}
+		report("collision+", start, ITERATIONS, sink);
+	}
+
+	// the same sweep with the bitmask collision kernel (fits() - borders included)
+	static void benchmarkFits()
+	{
+		Gameboard g;
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if ((x + y) % 3 != 0) {
+					g.setContent(x, y, 1);
+				}
+			}
+		}
+		const ShapeMask square = { 0, 0, { 0x3, 0x3, 0, 0 }, { 1, 1, -1, -1 } };
+		long long sink = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; i++) {
+			sink += g.fits(square, i % (Gameboard::MAX_X - 1), i % (Gameboard::MAX_Y - 1));
+		}
+		report("fits", start, ITERATIONS, sink);
+	}
+
+	// score every placement of a T on a half filled board, in batches (ns per placement)
+	static void benchmarkEvaluate()
+	{
+		Gameboard g;
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if ((x + y) % 3 != 0) {
+					g.setContent(x, y, 1);
+				}
+			}
+		}
+		GridTetromino t;
+		t.setShape(SHAPE_T);
+		t.setGridLoc(g.getSpawnLoc());
+		MoveGenerator generator;
+		int count = generator.generate(g, t);
+		std::vector<PackedPiece> pieces;
+		for (int i = 0; i < count; i++) {
+			pieces.push_back(generator.getPlacement(i).piece);
+		}
+		std::vector<double> scores(count);
+		BoardEvaluator evaluator;
+		double sink = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS / count; i++) {
+			evaluator.evaluatePlacements(g, pieces.data(), count, scores.data());
+			sink += scores[i % count];
+		}
+		report("evaluate", start, ITERATIONS / count * count, static_cast<long long>(sink));
+	}
+
+private:
+	// print ns/op for a workload of ops operations (sink keeps the optimizer from discarding the work)
+	static void report(const char* name, std::chrono::steady_clock::time_point start, int ops, long long sink)
+	{
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+		std::cout << " " << std::left << std::setw(12) << name
+			<< std::fixed << std::setprecision(2) << ns / ops << " ns/op"
+			<< "  (" << sink << ")\n";
+	}
+};
+
+#endif /* BENCHMARKSUITE_H */
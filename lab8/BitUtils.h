@@ -0,0 +1,87 @@
+// Small portable bit-twiddling helpers used by the bitboard code.
+// They map onto the compiler intrinsics (a single instruction on any
+// modern CPU) for both MSVC and GCC/Clang.
+
+#ifndef BITUTILS_H
+#define BITUTILS_H
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// return the number of set bits in value
+inline int popCount(std::uint64_t value)
+{
+#ifdef _MSC_VER
+#ifdef _WIN64
+	return static_cast<int>(__popcnt64(value));
+#else
+	return static_cast<int>(__popcnt(static_cast<unsigned int>(value)) + __popcnt(static_cast<unsigned int>(value >> 32)));
+#endif
+#elif defined(__POPCNT__)
+	return __builtin_popcountll(value);
+#else
+	// no popcnt instruction: count bits in parallel (SWAR) rather than
+	// calling the (table driven) runtime library routine
+	value = value - ((value >> 1) & 0x5555555555555555ULL);
+	value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+	value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// return the index of the lowest set bit in value
+//   value must not be 0
+inline int countTrailingZeros(std::uint64_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanForward64(&index, value);
+#else
+	if (!_BitScanForward(&index, static_cast<unsigned long>(value))) {
+		_BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+		index += 32;
+	}
+#endif
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+// return the index of the highest set bit in value
+//   value must not be 0
+inline int highestSetBit(std::uint64_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanReverse64(&index, value);
+#else
+	if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) {
+		index += 32;
+	}
+	else {
+		_BitScanReverse(&index, static_cast<unsigned long>(value));
+	}
+#endif
+	return static_cast<int>(index);
+#else
+	return 63 - __builtin_clzll(value);
+#endif
+}
+
+// scramble the bits of value (the splitmix64 finalizer): every input bit
+//   affects every output bit, so nearby inputs give unrelated outputs.
+//   constexpr, so hash key tables can be built at compile time (mix64(0) == 0).
+constexpr std::uint64_t mix64(std::uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+#endif /* BITUTILS_H */
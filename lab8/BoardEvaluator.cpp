@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include <limits>
+#include "BoardEvaluator.h"
+
+const int BoardEvaluator::BATCH_SIZE;
+const int BoardEvaluator::LANE_GROUP;
+
+// row masks of the batch: a full row, the left column of every neighbouring pair,
+//   the rightmost column, and the 2 wall bits of a walled row (the board shifted left 1)
+static const std::uint16_t FULL_LANE_ROW = static_cast<std::uint16_t>(Gameboard::FULL_ROW);
+static const std::uint16_t PAIR_COLUMNS = FULL_LANE_ROW >> 1;
+static const std::uint16_t RIGHT_COLUMN = static_cast<std::uint16_t>(1u << (Gameboard::MAX_X - 1));
+static const std::uint16_t WALL_COLUMNS = static_cast<std::uint16_t>(1u | (1u << (Gameboard::MAX_X + 1)));
+static const std::uint16_t WALLED_PAIRS = static_cast<std::uint16_t>((1u << (Gameboard::MAX_X + 1)) - 1);
+
+// return the # of set bits in a 16 bit value (SWAR: only shifts, ANDs & adds, so a
+//   loop of them vectorizes - there is no vector popcount before AVX-512)
+static inline std::uint16_t popCount16(std::uint16_t value) {
+	value = static_cast<std::uint16_t>(value - ((value >> 1) & 0x5555));
+	value = static_cast<std::uint16_t>((value & 0x3333) + ((value >> 2) & 0x3333));
+	value = static_cast<std::uint16_t>((value + (value >> 4)) & 0x0F0F);
+	return static_cast<std::uint16_t>((value + (value >> 8)) & 0x001F);
+}
+
+// constructor, scoring with weights
+//   (the batch is cleared: the lanes past the last placement of a group are featured too)
+BoardEvaluator::BoardEvaluator(const EvaluatorWeights& weights) : weights(weights) {
+	std::memset(laneRows, 0, sizeof(laneRows));
+	std::memset(rowsCleared, 0, sizeof(rowsCleared));
+}
+
+// return the weights
+const EvaluatorWeights& BoardEvaluator::getWeights() const {
+	return weights;
+}
+
+// return the features of board (rowsCleared: the # of rows the last placement cleared)
+//   (a batch of one)
+BoardFeatures BoardEvaluator::getFeatures(const Gameboard& board, int rowsCleared) {
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		laneRows[y][0] = board.getRowMask(y);
+	}
+	this->rowsCleared[0] = static_cast<LaneRow>(rowsCleared);
+	extractFeatures(1);
+	return getLaneFeatures(0);
+}
+
+// return the score of features (higher is better)
+double BoardEvaluator::score(const BoardFeatures& features) const {
+	return weights.rowsCleared * features.rowsCleared
+		+ weights.aggregateHeight * features.aggregateHeight
+		+ weights.holes * features.holes
+		+ weights.bumpiness * features.bumpiness
+		+ weights.wells * features.wells
+		+ weights.rowTransitions * features.rowTransitions
+		+ weights.columnTransitions * features.columnTransitions;
+}
+
+// return the score of board (after a placement that cleared rowsCleared rows)
+double BoardEvaluator::evaluate(const Gameboard& board, int rowsCleared) {
+	return score(getFeatures(board, rowsCleared));
+}
+
+// score the boards left by count placements on board: lock each piece, remove the
+//   rows it completes & score the board (-infinity if it locks out)
+//   scores[i] (& features[i], if features isn't null) is the result of pieces[i]
+//   (the pieces must fit on board - eg: the placements of a MoveGenerator)
+void BoardEvaluator::evaluatePlacements(const Gameboard& board, const PackedPiece* pieces, int count,
+	double* scores, BoardFeatures* features) {
+	Gameboard::RowMask rows[Gameboard::MAX_Y];
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		rows[y] = board.getRowMask(y);
+	}
+	evaluatePlacements(rows, pieces, count, scores, features);
+}
+
+// the same, on the board with row masks rows[0..MAX_Y - 1] (eg: a search node's board)
+//   The placements are loaded & featured BATCH_SIZE at a time.
+void BoardEvaluator::evaluatePlacements(const Gameboard::RowMask* rows, const PackedPiece* pieces, int count,
+	double* scores, BoardFeatures* features) {
+	for (int first = 0; first < count; first += BATCH_SIZE) {
+		int lanes = std::min(count - first, BATCH_SIZE);
+		for (int lane = 0; lane < lanes; lane++) {
+			lockedOut[lane] = !loadPlacement(lane, rows, pieces[first + lane]);
+		}
+		extractFeatures(lanes);
+		for (int lane = 0; lane < lanes; lane++) {
+			BoardFeatures laneFeatures = getLaneFeatures(lane);
+			scores[first + lane] = lockedOut[lane] ? -std::numeric_limits<double>::infinity() : score(laneFeatures);
+			if (features) {
+				features[first + lane] = laneFeatures;
+			}
+		}
+	}
+}
+
+// lock piece into the board with row masks rows, into lockedRows (which may be rows):
+//   remove the rows it completes & return their #, or -1 if it locks out
+//   (lockedRows is left as is)
+//   Only the rows the piece covers can complete (the board has no full rows): if any
+//   did, the rows above them are moved down over them & the top refilled with empty rows.
+int BoardEvaluator::lockPiece(const Gameboard::RowMask* rows, const PackedPiece& piece, Gameboard::RowMask* lockedRows) {
+	const ShapeMask& mask = Tetromino::MASK_TABLE.masks[piece.shape][piece.rotation];
+	int top = piece.y + mask.top;
+	int shift = piece.x + mask.left;
+	assert(shift >= 0);
+	if (top < 0) {
+		return -1;
+	}
+	if (lockedRows != rows) {
+		std::memcpy(lockedRows, rows, Gameboard::MAX_Y * sizeof(Gameboard::RowMask));
+	}
+
+	int bottom = top;		// the last row the piece covers
+	bool completed = false;
+	for (int i = 0; i < ShapeMask::ROWS && mask.rows[i] != 0; i++) {
+		assert(top + i < Gameboard::MAX_Y && (rows[top + i] & (mask.rows[i] << shift)) == 0);
+		lockedRows[top + i] |= static_cast<Gameboard::RowMask>(mask.rows[i] << shift);
+		completed = completed || lockedRows[top + i] == Gameboard::FULL_ROW;
+		bottom = top + i;
+	}
+	if (!completed) {
+		return 0;
+	}
+	int target = bottom;	// the row the next kept row moves to
+	for (int y = bottom; y >= 0; y--) {
+		Gameboard::RowMask row = lockedRows[y];
+		if (row != Gameboard::FULL_ROW) {
+			lockedRows[target--] = row;
+		}
+	}
+	for (int y = target; y >= 0; y--) {
+		lockedRows[y] = 0;
+	}
+	return target + 1;
+}
+
+// load lane # lane of the batch with board's rows & piece locked in (see lockPiece()):
+//   return false if it locks out (the lane is left as board)
+bool BoardEvaluator::loadPlacement(int lane, const Gameboard::RowMask* boardRows, const PackedPiece& piece) {
+	Gameboard::RowMask locked[Gameboard::MAX_Y];
+	int cleared = lockPiece(boardRows, piece, locked);
+	const Gameboard::RowMask* rows = (cleared < 0) ? boardRows : locked;
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		laneRows[y][lane] = rows[y];
+	}
+	rowsCleared[lane] = static_cast<LaneRow>(std::max(cleared, 0));
+	return cleared >= 0;
+}
+
+// extract the features of lanes 0..lanes - 1 (the kernel: one pass over the rows,
+//   every lane at once - in whole groups of LANE_GROUP lanes)
+//   Row by row from the top, with cover = the OR of the rows so far (bit x set once
+//   column x has had a block):
+//   - holes: the empty cells of the row under the cover (cover before the row)
+//   - aggregate height: a column's height is the # of rows it is covered in
+//   - bumpiness: |height x - height x + 1| is the # of rows one of them is covered in
+//   - wells: a column's well depth is the # of rows it isn't covered in, but both of its
+//     neighbours (or the walls) are
+//   - row transitions: the walled row XOR itself moved one column
+//   - column transitions: the row XOR the row above (empty above the board, & the floor
+//     is a full row)
+void BoardEvaluator::extractFeatures(int lanes) {
+	LaneRow cover[BATCH_SIZE];
+	LaneRow above[BATCH_SIZE];
+	int groups = (lanes + LANE_GROUP - 1) / LANE_GROUP;
+	for (int lane = 0; lane < groups * LANE_GROUP; lane++) {
+		cover[lane] = 0;
+		above[lane] = 0;
+		aggregateHeight[lane] = 0;
+		holes[lane] = 0;
+		bumpiness[lane] = 0;
+		wells[lane] = 0;
+		rowTransitions[lane] = 0;
+		columnTransitions[lane] = 0;
+	}
+	for (int group = 0; group < groups * LANE_GROUP; group += LANE_GROUP) {
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			const LaneRow* rows = laneRows[y];
+			for (int lane = group; lane < group + LANE_GROUP; lane++) {
+				LaneRow row = rows[lane];
+				LaneRow covered = static_cast<LaneRow>(cover[lane] | row);
+				LaneRow leftCovered = static_cast<LaneRow>((covered << 1) | 1);
+				LaneRow rightCovered = static_cast<LaneRow>((covered >> 1) | RIGHT_COLUMN);
+				LaneRow walled = static_cast<LaneRow>((row << 1) | WALL_COLUMNS);
+				holes[lane] += popCount16(static_cast<LaneRow>(cover[lane] & ~row));
+				aggregateHeight[lane] += popCount16(covered);
+				bumpiness[lane] += popCount16(static_cast<LaneRow>((covered ^ (covered >> 1)) & PAIR_COLUMNS));
+				wells[lane] += popCount16(static_cast<LaneRow>(~covered & leftCovered & rightCovered & FULL_LANE_ROW));
+				rowTransitions[lane] += popCount16(static_cast<LaneRow>((walled ^ (walled >> 1)) & WALLED_PAIRS));
+				columnTransitions[lane] += popCount16(static_cast<LaneRow>(row ^ above[lane]));
+				cover[lane] = covered;
+				above[lane] = row;
+			}
+		}
+	}
+	for (int lane = 0; lane < lanes; lane++) {
+		columnTransitions[lane] += popCount16(static_cast<LaneRow>(above[lane] ^ FULL_LANE_ROW));
+	}
+}
+
+// return the features of a lane (after extractFeatures())
+BoardFeatures BoardEvaluator::getLaneFeatures(int lane) const {
+	BoardFeatures features;
+	features.rowsCleared = rowsCleared[lane];
+	features.aggregateHeight = aggregateHeight[lane];
+	features.holes = holes[lane];
+	features.bumpiness = bumpiness[lane];
+	features.wells = wells[lane];
+	features.rowTransitions = rowTransitions[lane];
+	features.columnTransitions = columnTransitions[lane];
+	return features;
+}
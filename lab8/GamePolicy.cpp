@@ -0,0 +1,223 @@
+#include <assert.h>
+#include <limits>
+#include "GamePolicy.h"
+#include "BitUtils.h"
+
+// the most actions a PlacementPolicy takes for one shape before it gives up & hard drops
+//   (enough to turn twice & cross the board)
+static const int MAX_PLACEMENT_STEPS = 2 + 2 * Gameboard::MAX_X;
+
+// the weights of the board features (the BoardEvaluator's defaults: only the rows
+//   cleared, aggregate height, holes & bumpiness weights are used)
+const EvaluatorWeights GreedyPolicy::WEIGHTS{};
+
+// return a new policy by name: "random", "greedy", "beam" or "scripted" (playing script)
+//   - return nullptr for an unknown name (or an invalid script)
+std::unique_ptr<GamePolicy> GamePolicy::create(const std::string& name, const std::string& script) {
+	if (name == "random") {
+		return std::unique_ptr<GamePolicy>(new RandomPolicy());
+	}
+	if (name == "greedy") {
+		return std::unique_ptr<GamePolicy>(new GreedyPolicy());
+	}
+	if (name == "beam") {
+		return std::unique_ptr<GamePolicy>(new BeamSearchPolicy());
+	}
+	if (name == "scripted" && ScriptedPolicy::isValidScript(script)) {
+		return std::unique_ptr<GamePolicy>(new ScriptedPolicy(script));
+	}
+	return nullptr;
+}
+
+// return the action for one script letter (ACTION_COUNT if it isn't one)
+static InputAction getScriptAction(char letter) {
+	switch (letter) {
+	case 'L': return ACTION_LEFT;
+	case 'R': return ACTION_RIGHT;
+	case 'D': return ACTION_SOFT_DROP;
+	case 'H': return ACTION_HARD_DROP;
+	case 'X': return ACTION_ROTATE_CW;
+	case 'Z': return ACTION_ROTATE_CCW;
+	case 'A': return ACTION_ROTATE_180;
+	case 'C': return ACTION_HOLD;
+	default: return ACTION_COUNT;
+	}
+}
+
+// constructor, script must be a valid, non empty script (see isValidScript())
+ScriptedPolicy::ScriptedPolicy(const std::string& script) : script(script) {
+	assert(isValidScript(script));
+}
+
+// return true if every letter of script is an action (and it isn't empty)
+bool ScriptedPolicy::isValidScript(const std::string& script) {
+	for (char letter : script) {
+		if (getScriptAction(letter) == ACTION_COUNT) {
+			return false;
+		}
+	}
+	return !script.empty();
+}
+
+// restart the script
+void ScriptedPolicy::reset(std::uint64_t /*seed*/) {
+	position = 0;
+}
+
+// return the next action of the script (wrapping around at the end)
+InputAction ScriptedPolicy::nextAction(const TetrisSimulation& /*game*/) {
+	InputAction action = getScriptAction(script[position]);
+	position = (position + 1) % script.size();
+	return action;
+}
+
+const char* ScriptedPolicy::getName() const {
+	return "scripted";
+}
+
+void PlacementPolicy::reset(std::uint64_t /*seed*/) {
+	plannedPiece = -1;
+	steps = 0;
+}
+
+// the next action towards the chosen placement (choosing one for each new shape)
+//   if the shape can't get there (it is blocked), it is hard dropped where it is.
+InputAction PlacementPolicy::nextAction(const TetrisSimulation& game) {
+	if (game.getPiecesLocked() != plannedPiece) {
+		plannedPiece = game.getPiecesLocked();
+		steps = 0;
+		choosePlacement(game, plannedRotation, plannedX);
+	}
+	if (++steps > MAX_PLACEMENT_STEPS) {
+		return ACTION_HARD_DROP;
+	}
+	const GridTetromino& shape = game.getCurrentShape();
+	switch ((plannedRotation - shape.getRotation() + TetrominoRotationTable::ROTATIONS) % TetrominoRotationTable::ROTATIONS) {
+	case 1: return ACTION_ROTATE_CW;
+	case 2: return ACTION_ROTATE_180;
+	case 3: return ACTION_ROTATE_CCW;
+	default: break;
+	}
+	if (shape.getGridLoc().getX() < plannedX) {
+		return ACTION_RIGHT;
+	}
+	if (shape.getGridLoc().getX() > plannedX) {
+		return ACTION_LEFT;
+	}
+	return ACTION_HARD_DROP;
+}
+
+// return the range of grid x (first, last) at which the current shape of game, turned
+//   to rotation, is within the left & right borders
+void PlacementPolicy::getColumnRange(const TetrisSimulation& game, int rotation, int& first, int& last) {
+	const ShapeMask& mask = game.getCurrentShape().getShapeMask(rotation);
+	int columns = 0;
+	for (int row = 0; row < ShapeMask::ROWS; row++) {
+		columns |= mask.rows[row];
+	}
+	int width = highestSetBit(static_cast<std::uint64_t>(columns)) + 1;
+	first = -mask.left;
+	last = Gameboard::MAX_X - width - mask.left;
+}
+
+// restart the random sequence from seed
+void RandomPolicy::reset(std::uint64_t seed) {
+	PlacementPolicy::reset(seed);
+	this->seed = seed;
+	counter = 0;
+}
+
+const char* RandomPolicy::getName() const {
+	return "random";
+}
+
+void RandomPolicy::choosePlacement(const TetrisSimulation& game, int& rotation, int& x) {
+	std::uint64_t bits = PieceGenerator::random(seed, counter++);
+	rotation = static_cast<int>(bits % TetrominoRotationTable::ROTATIONS);
+	int first, last;
+	getColumnRange(game, rotation, first, last);
+	x = first + static_cast<int>((bits >> 32) % static_cast<std::uint64_t>(last - first + 1));
+}
+
+const char* GreedyPolicy::getName() const {
+	return "greedy";
+}
+
+// return the score of a board (higher is better) after rowsCleared rows were cleared
+double GreedyPolicy::evaluate(const Gameboard& board, int rowsCleared) {
+	return WEIGHTS.rowsCleared * rowsCleared
+		+ WEIGHTS.aggregateHeight * board.getAggregateHeight()
+		+ WEIGHTS.holes * board.getHoleCount()
+		+ WEIGHTS.bumpiness * board.getBumpiness();
+}
+
+void GreedyPolicy::choosePlacement(const TetrisSimulation& game, int& rotation, int& x) {
+	const Gameboard& board = game.getBoard();
+	GridTetromino shape = game.getCurrentShape();
+	int y = shape.getGridLoc().getY();
+	double bestScore = -std::numeric_limits<double>::infinity();
+	rotation = shape.getRotation();
+	x = shape.getGridLoc().getX();
+
+	for (int r = 0; r < TetrominoRotationTable::ROTATIONS; r++) {
+		shape.setRotation(r);
+		const ShapeMask& mask = shape.getShapeMask();
+		int first, last;
+		getColumnRange(game, r, first, last);
+		for (int px = first; px <= last; px++) {
+			if (!board.fits(mask, px, y)) {
+				continue;
+			}
+			int landY = y + board.getDropDistance(mask, px, y);
+			Gameboard after = board;
+			for (const Point& loc : shape.getBlockLocs()) {	// (blocks above the board are lost, as in a lock)
+				if (loc.getY() + landY >= 0) {
+					after.setContent(loc.getX() + px, loc.getY() + landY, static_cast<int>(shape.getColor()));
+				}
+			}
+			double score = evaluate(after, after.removeCompletedRows());
+			if (score > bestScore) {
+				bestScore = score;
+				rotation = r;
+				x = px;
+			}
+		}
+	}
+}
+
+// constructor, searching with a BeamSearch of beamWidth, depth & timeBudgetMicros,
+//   sharing table (nullptr = none: it isn't owned - eg: one table for every thread)
+BeamSearchPolicy::BeamSearchPolicy(int beamWidth, int depth, std::int64_t timeBudgetMicros, TranspositionTable* table)
+	: search(beamWidth, depth, timeBudgetMicros) {
+	search.setTranspositionTable(table);
+}
+
+void BeamSearchPolicy::reset(std::uint64_t /*seed*/) {
+	plannedPiece = -1;
+	hasPath = false;
+	step = 0;
+}
+
+// the next action of the path to the chosen placement (searching for each new shape)
+//   (the path ends with a hard drop: a shape is only still falling after it if
+//    something - eg: gravity - moved it off the path, so it is hard dropped there)
+InputAction BeamSearchPolicy::nextAction(const TetrisSimulation& game) {
+	if (game.getPiecesLocked() != plannedPiece) {
+		plannedPiece = game.getPiecesLocked();
+		hasPath = search.search(game);
+		step = 0;
+	}
+	if (!hasPath || step >= search.getBestPathLength()) {
+		return ACTION_HARD_DROP;
+	}
+	return search.getBestPath()[step++];
+}
+
+const char* BeamSearchPolicy::getName() const {
+	return "beam";
+}
+
+// return the search (its settings & the results of the last search)
+const BeamSearch& BeamSearchPolicy::getSearch() const {
+	return search;
+}
@@ -0,0 +1,155 @@
+// A GamePolicy plays a TetrisSimulation: it is asked for one InputAction at a time.
+// Headless drivers (the batch runner, benchmarks, tests) play games through this
+// interface, so any player - random, scripted or an AI - can be plugged in.
+//
+// Policies:
+//  - ScriptedPolicy:  repeats a fixed string of actions (one letter per action).
+//  - PlacementPolicy: the base of policies that choose where each shape goes
+//                     (a rotation & column) and then steer it there & hard drop.
+//  - RandomPolicy:    a placement policy that picks uniformly at random (seeded).
+//  - GreedyPolicy:    a placement policy that tries every rotation & column and
+//                     keeps the one that leaves the best board (1 shape lookahead).
+//  - BeamSearchPolicy: plays the placement a BeamSearch finds (looking ahead at the
+//                     preview) by the input path the move generator found to it.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef GAMEPOLICY_H
+#define GAMEPOLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "BeamSearch.h"
+#include "TetrisSimulation.h"
+
+class GamePolicy
+{
+public:
+	virtual ~GamePolicy() {}
+
+	// get ready for a new game
+	//   (seed: for policies that make random choices - the same seed, the same game)
+	virtual void reset(std::uint64_t seed) = 0;
+
+	// return the next action to apply to game (the current state of the game)
+	virtual InputAction nextAction(const TetrisSimulation& game) = 0;
+
+	// return the policy's name (for reports)
+	virtual const char* getName() const = 0;
+
+	// return a new policy by name: "random", "greedy", "beam" or "scripted" (playing script)
+	//   - return nullptr for an unknown name (or an invalid script)
+	static std::unique_ptr<GamePolicy> create(const std::string& name, const std::string& script = "");
+};
+
+// repeats a fixed string of actions, one letter per action:
+//   L = left, R = right, D = soft drop, H = hard drop,
+//   X = rotate CW, Z = rotate CCW, A = rotate 180, C = hold
+class ScriptedPolicy : public GamePolicy
+{
+public:
+	// constructor, script must be a valid, non empty script (see isValidScript())
+	ScriptedPolicy(const std::string& script);
+
+	// return true if every letter of script is an action (and it isn't empty)
+	static bool isValidScript(const std::string& script);
+
+	// restart the script
+	void reset(std::uint64_t seed) override;
+	// return the next action of the script (wrapping around at the end)
+	InputAction nextAction(const TetrisSimulation& game) override;
+	const char* getName() const override;
+
+private:
+	std::string script;			// the actions, as letters
+	std::size_t position = 0;	// the next letter to play
+};
+
+// the base of policies that choose a placement for each shape, then steer it there:
+//   rotate (the shortest way), move sideways, hard drop.
+class PlacementPolicy : public GamePolicy
+{
+public:
+	void reset(std::uint64_t seed) override;
+	// the next action towards the chosen placement (choosing one for each new shape)
+	//   if the shape can't get there (it is blocked), it is hard dropped where it is.
+	InputAction nextAction(const TetrisSimulation& game) override;
+
+protected:
+	// choose the rotation & grid x to drop the current shape of game at
+	virtual void choosePlacement(const TetrisSimulation& game, int& rotation, int& x) = 0;
+
+	// return the range of grid x (first, last) at which the current shape of game, turned
+	//   to rotation, is within the left & right borders
+	static void getColumnRange(const TetrisSimulation& game, int rotation, int& first, int& last);
+
+private:
+	int plannedPiece = -1;		// the # of shapes locked when the current plan was made
+	int plannedRotation = 0;	// the plan: the rotation & grid x to drop at
+	int plannedX = 0;
+	int steps = 0;				// the # of actions taken for the current shape
+};
+
+// drops each shape at a uniformly random rotation & column
+class RandomPolicy : public PlacementPolicy
+{
+public:
+	// restart the random sequence from seed
+	void reset(std::uint64_t seed) override;
+	const char* getName() const override;
+
+protected:
+	void choosePlacement(const TetrisSimulation& game, int& rotation, int& x) override;
+
+private:
+	std::uint64_t seed = 0;		// the PRNG key (PieceGenerator::random())
+	std::uint64_t counter = 0;	// the # of random numbers drawn
+};
+
+// drops each shape where it leaves the best board: tries every rotation & column
+//   and scores the board after it lands (& clears rows) with a weighted sum of
+//   rows cleared, aggregate height, holes & bumpiness (the gameboard's profile).
+class GreedyPolicy : public PlacementPolicy
+{
+public:
+	// the weights of the board features (the BoardEvaluator's defaults: only the rows
+	//   cleared, aggregate height, holes & bumpiness weights are used)
+	static const EvaluatorWeights WEIGHTS;
+
+	const char* getName() const override;
+
+	// return the score of a board (higher is better) after rowsCleared rows were cleared
+	static double evaluate(const Gameboard& board, int rowsCleared);
+
+protected:
+	void choosePlacement(const TetrisSimulation& game, int& rotation, int& x) override;
+};
+
+// drops each shape where a beam search over the current shape & the preview says
+//   (see BeamSearch), along the shortest input path to it: tucks & spins included.
+//   A shape with nowhere to go (or whose path has run out) is hard dropped.
+class BeamSearchPolicy : public GamePolicy
+{
+public:
+	// constructor, searching with a BeamSearch of beamWidth, depth & timeBudgetMicros,
+	//   sharing table (nullptr = none: it isn't owned - eg: one table for every thread)
+	BeamSearchPolicy(int beamWidth = BeamSearch::DEFAULT_BEAM_WIDTH, int depth = BeamSearch::DEFAULT_DEPTH,
+		std::int64_t timeBudgetMicros = 0, TranspositionTable* table = nullptr);
+
+	void reset(std::uint64_t seed) override;
+	// the next action of the path to the chosen placement (searching for each new shape)
+	InputAction nextAction(const TetrisSimulation& game) override;
+	const char* getName() const override;
+
+	// return the search (its settings & the results of the last search)
+	const BeamSearch& getSearch() const;
+
+private:
+	BeamSearch search;			// chooses the placements
+	int plannedPiece = -1;		// the # of shapes locked when the current path was found
+	bool hasPath = false;		// false if the search found no placement
+	int step = 0;				// the next action of the path
+};
+
+#endif /* GAMEPOLICY_H */
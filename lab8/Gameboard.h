@@ -34,15 +34,39 @@
 //     considered top left).
 //
 // - *** IMPORTANT ***
-//   Note that a 2D array normally has a[row][col] orientation (row-major ordering).  Since this
-//     grid is used as a co-ordinate system, an[x][y] orientation is used where x (representing 
-//     the column index) comes first, and y (representing the row index) comes second. This is 
-//     the opposite of what you'd normally expect of a 2D array.  If you were to print out the 2D
-//     array using a [row][column] orientation, you would find that it is horizontal instead
-//     of vertical and you will likely exceed the bounds of the arrays!  If you simply think in
-//     terms of an x, y co-ordinate system, you should be fine. Use 2 for loops to initialize
-//     the array. Using an initializer list would be very confusing (because of the 
-//     orientation change).
+//   The public interface is an x, y co-ordinate system where x (representing the column
+//     index) comes first, and y (representing the row index) comes second.
+//     Internally the grid is stored row-major (grid[y][x]) so that each row is a contiguous
+//     block of memory: every row operation (fillRow, copyRowIntoRow, removing rows) works
+//     on whole rows with memset/memcpy/memmove instead of striding across columns.
+//     Cells are stored as single bytes and rows are padded to ROW_STRIDE bytes, so the whole
+//     grid fits in a handful of cache lines. Only index grid through the x, y accessors!
+//
+// - Alongside the grid (which holds the colors used for rendering), the board keeps an
+//     occupancy bitboard: one RowMask per row, where bit x is set when grid[x][y] holds
+//     content. All occupancy questions (is a row full? are these locs empty?) are answered
+//     from the bitboard, so a full row is a single compare and a collision test is an AND
+//     per block. setContent(), fillRow() and copyRowIntoRow() keep the two in sync.
+//     A walled copy of the bitboard (every row shifted past a few solid "wall" columns,
+//     with open rows above the board and solid "floor" rows below it) lets fits() test a
+//     whole piece - borders included - with 4 shifted ANDs and no branches.
+//
+// - The board also caches its surface profile (column heights, holes, wells & bumpiness)
+//     for the AI. Each column keeps a RowIndexMask of its occupied rows. Changes only mark
+//     the columns they touch stale, and the next profile query recomputes just those from
+//     their masks, so repeated queries are O(1). Define GAMEBOARD_VERIFY_PROFILE to cross-check the
+//     cache against a full recomputation (from the grid) after every change.
+//
+// - The board carries a 64 bit Zobrist style hash of its content (for deduplicating
+//     positions). Each row keeps the XOR of one key per occupied cell (the keys come from
+//     a table built at compile time), and the board hash is the XOR of every row's hash
+//     mixed with its row index. A setContent() changes one row hash, fillRow() recomputes
+//     one row, and removing rows just moves the row hashes with the rows - no cell is ever
+//     rehashed. Changed rows are folded back into the board hash by the next getHash().
+//
+// - The board dimensions are template parameters (BasicGameboard<WIDTH, HEIGHT>); the
+//     member functions live in Gameboard.inl so every instantiation can be inlined and
+//     unrolled. Gameboard is the standard 10 x 19 board.
 //
 //  [expected .cpp size: ~ 150 lines]
 
@@ -51,21 +75,97 @@
 #define GAMEBOARD_H
 
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
 #include "Point.h"
+#include "BitUtils.h"
+#include "ShapeMask.h"
+
+// the narrowest unsigned integer type with at least BITS bits
+//   (used to pick the row mask type for a board width, and the
+//   row index mask type for a board height)
+template <int BITS>
+struct NarrowestUInt
+{
+	static_assert(BITS > 0 && BITS <= 64, "bitboards support 1 to 64 bits");
+	typedef typename std::conditional<(BITS <= 8), std::uint8_t,
+		typename std::conditional<(BITS <= 16), std::uint16_t,
+		typename std::conditional<(BITS <= 32), std::uint32_t,
+		std::uint64_t>::type>::type>::type type;
+};
+
+// the Zobrist keys for the cells of a WIDTH wide gameboard: one key per column & content,
+//   for the contents 0..CONTENTS-1 (the TetColors). Built at compile time from mix64(),
+//   so the keys (and every board hash) are the same from run to run.
+template <int WIDTH>
+struct GameboardCellKeys
+{
+	static const int CONTENTS = 8;
+	std::uint64_t keys[WIDTH][CONTENTS];
+
+	constexpr GameboardCellKeys() : keys() {
+		for (int x = 0; x < WIDTH; x++) {
+			for (int content = 0; content < CONTENTS; content++) {
+				keys[x][content] = key(x, content);
+			}
+		}
+	}
+
+	// return the key of any (non empty) content at column x - the table holds these
+	static constexpr std::uint64_t key(int x, int content) {
+		return mix64(((static_cast<std::uint64_t>(x) << 8) | static_cast<std::uint8_t>(content))
+			+ 0x9E3779B97F4A7C15ULL);
+	}
+};
 
-class Gameboard
+// A gameboard of WIDTH x HEIGHT blocks.
+//   The dimensions are template parameters so every loop bound is a compile
+//   time constant (which the compiler can unroll and vectorize), and the
+//   row mask is the narrowest integer type that fits WIDTH bits.
+//   Use the Gameboard typedef (below) for the standard 10x19 board.
+template <int WIDTH, int HEIGHT>
+class BasicGameboard
 {
 public:
 	// CONSTANTS
-	static const int MAX_X = 10;		// gameboard x dimension
-	static const int MAX_Y = 19;		// gameboard y dimension
+	static const int MAX_X = WIDTH;		// gameboard x dimension
+	static const int MAX_Y = HEIGHT;	// gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// contents of an empty block
 
+	// one row of the occupancy bitboard (bit x set = column x is occupied)
+	typedef typename NarrowestUInt<MAX_X>::type RowMask;
+	// the mask of a completed row
+	static const RowMask FULL_ROW = static_cast<RowMask>(~RowMask(0)) >> (sizeof(RowMask) * 8 - MAX_X);
+
+	// a set of row indices (bit y set = row y is in the set)
+	typedef typename std::conditional<(MAX_Y <= 32), std::uint32_t, std::uint64_t>::type RowIndexMask;
+	// the set of every row of the board
+	static const RowIndexMask ALL_ROWS = static_cast<RowIndexMask>(~RowIndexMask(0)) >> (sizeof(RowIndexMask) * 8 - MAX_Y);
+
+	// the stored content of one grid cell (EMPTY_BLOCK or a color)
+	typedef std::int8_t Cell;
+	// bytes per stored grid row (MAX_X rounded up to a 16 byte boundary)
+	static const std::size_t ROW_STRIDE = (MAX_X + 15) / 16 * 16;
+
+	// one row of the walled bitboard (see fits()): the row mask shifted up by WALL_BITS,
+	//   with every bit outside the board set (the left & right walls)
+	typedef std::uint64_t WalledRow;
+	static const int WALL_BITS = ShapeMask::COLUMNS;	// wall columns left of the board
+	static const int CEILING_ROWS = ShapeMask::ROWS;	// open rows above the board
+	static const int FLOOR_ROWS = ShapeMask::ROWS;		// solid rows below the board
+	static const WalledRow WALLS = ~(WalledRow(FULL_ROW) << WALL_BITS);
+
+	static_assert(MAX_X > 0 && MAX_X + 2 * WALL_BITS <= 64, "a gameboard row (& its walls) must fit in a 64 bit mask");
+	static_assert(MAX_Y > 0 && MAX_Y <= 64, "a gameboard must have at most 64 rows");
+	static_assert(ShapeMask::ROWS == 4, "fits() tests exactly 4 shape rows");
+
 	// MEMBER FUNCTIONS
 
 	
 	// constructor - empty() the grid
-	Gameboard();								
+	BasicGameboard();								
     
 	// return the content at a given point
 	int getContent(Point pt) const;				
@@ -78,7 +178,13 @@ public:
 	void setContent(int x, int y, int content);	
 	
 	// set the content for an array of grid locs
-	void setContent(std::vector<Point> locs, int content);	
+	void setContent(const std::vector<Point>& locs, int content);	
+	// set the content for count grid locs, each moved by [xOffset, yOffset]
+	//   (the locs are read in place: no copies, no allocations)
+	void setContent(const Point* locs, int count, int xOffset, int yOffset, int content);
+	// set the content for a fixed size array of grid locs, each moved by offset
+	template <std::size_t N>
+	void setContent(const std::array<Point, N>& locs, Point offset, int content);
 
 	
 	// return true if the content at ALL (valid) points is empty
@@ -88,15 +194,102 @@ public:
 	//   don't use them to index into the grid).  Testing invalid points
 	//   would likely result in an out of bounds error or segmentation fault!
 	//   If no points are valid, return true
-	bool areLocsEmpty(std::vector<Point> locs) const;
+	bool areLocsEmpty(const std::vector<Point>& locs) const;
+	// same as areLocsEmpty(locs), for count locs each moved by [xOffset, yOffset]
+	//   (the locs are read in place: no copies, no allocations)
+	bool areLocsEmpty(const Point* locs, int count, int xOffset, int yOffset) const;
+	// same as areLocsEmpty(locs), for a fixed size array of locs each moved by offset
+	template <std::size_t N>
+	bool areLocsEmpty(const std::array<Point, N>& locs, Point offset) const;
+
+	// return true if a shape with its origin at [x,y] fits: all of its blocks are within
+	//   the left, right & lower borders, and none of them overlaps content.
+	//   (the area above the board is open: blocks there are out of the grid, but fit,
+	//    so a shape can spawn or rotate partly above row 0)
+	//   The collision kernel: one shifted AND per shape row against the walled
+	//   bitboard, with no branches (out of range positions are clamped into the walls).
+	bool fits(const ShapeMask& shape, int x, int y) const;
+	// same as fits(shape, x, y), with the origin at loc
+	bool fits(const ShapeMask& shape, Point loc) const;
+
+	// return how many rows a shape with its origin at [x,y] can fall before it
+	//   lands on content or the floor (0 if it can't move down at all).
+	//   The shape must fit at [x,y]. O(1): one scan (a shift & count trailing
+	//   zeros) of the column mask under the lowest block of each shape column.
+	//   Use it for hard drops and to place the ghost piece.
+	int getDropDistance(const ShapeMask& shape, int x, int y) const;
+	// same as getDropDistance(shape, x, y), with the origin at loc
+	int getDropDistance(const ShapeMask& shape, Point loc) const;
+
+	// return the occupancy bitmask of a given row (bit x set = grid[x][rowIndex] has content)
+	RowMask getRowMask(int rowIndex) const;
+	// return a 64 bit hash of an occupancy given as row masks rows[0..MAX_Y - 1] (eg: a
+	//   board's getRowMask()s, or a search's copy of them) - unlike getHash(), colors don't
+	//   count and nothing is cached: for search code that keeps boards as bare row masks
+	static std::uint64_t getOccupancyHash(const RowMask* rows);
+
+	// return the # of occupied blocks in a given row
+	//   (a popcount of the row's occupancy mask - always up to date)
+	int getRowFillCount(int rowIndex) const;
+
+	// return the set of rows whose content changed since the last call
+	//   (bit y set = row y changed), and start tracking afresh.
+	RowIndexMask takeDirtyRows();
+
+	// SURFACE PROFILE (cached & kept up to date incrementally)
+	//   setContent() & row removal keep the column masks exact and mark the
+	//   columns they touched stale; the first query after a change refreshes
+	//   just those columns (and their neighbours' totals). Every other query is O(1).
+
+	// return the occupancy bitmask of a given column (bit y set = grid[columnIndex][y] has content)
+	RowIndexMask getColumnMask(int columnIndex) const;
+	// return the height of a column: the # of rows from the bottom of the board
+	//   up to (and including) its highest block. 0 for an empty column.
+	int getColumnHeight(int columnIndex) const;
+	// return the # of holes in a column (empty cells with a block somewhere above them)
+	int getColumnHoles(int columnIndex) const;
+	// return the depth of the well at a column: how far the column is below the lower
+	//   of its two neighbours (the walls count as full height), or 0 if it isn't below both.
+	int getWellDepth(int columnIndex) const;
+	// return the sum of all column heights
+	int getAggregateHeight() const;
+	// return the # of holes on the board
+	int getHoleCount() const;
+	// return the sum of the height differences between neighbouring columns
+	int getBumpiness() const;
+	// return the sum of all well depths
+	int getWellDepthSum() const;
+
+	// recompute the whole profile from the grid and return true if it matches the
+	//   cached one (for debugging - this is a full O(board) scan).
+	bool isProfileConsistent() const;
+
+	// return a 64 bit hash of the board content (every cell's occupancy & color)
+	//   Kept up to date incrementally: O(1) plus one mix per row changed since the last
+	//   call. The keys are fixed (not random), so a hash is the same from run to run and
+	//   can be stored. An empty board hashes to 0.
+	std::uint64_t getHash() const;
+
+	// recompute the hash from the grid and return true if it matches the
+	//   cached one (for debugging - this is a full O(board) scan).
+	bool isHashConsistent() const;
 												
 	// removes all completed rows from the board
-	//   use getCompletedRowIndices() and removeRows() 
+	//   use clearCompletedRows()
 	//   return the # of completed rows removed
 	int removeCompletedRows();			
+
+	// find all completed rows and remove them in a single stable pass
+	//   (see compactRows()).
+	//   Only rows that were filled since the previous call can have become
+	//   completed, so only those are checked: after locking a tetromino this
+	//   costs O(rows touched), not O(board).
+	//   return the set of cleared row indices (bit y set = row y was cleared)
+	RowIndexMask clearCompletedRows();
 												
 	// fill the board with EMPTY_BLOCK 
-	//   (iterate through each rowIndex and fillRow() with EMPTY_BLOCK))
+	//   (the rows are contiguous, so the grid and bitboard are each cleared
+	//   with a single block fill rather than a fillRow() per row)
 	void empty();								
 												
 	// getter for the spawnLoc for new blocks
@@ -108,6 +301,48 @@ public:
 
 
 private:
+	// return the occupancy bit for column x
+	static RowMask columnBit(int x);
+
+	// record that a block of count rows starting at rowIndex has changed
+	//   (and rebuild their walled rows from the row masks).
+	//   mayBeCompleted: the rows may now be completed (clearCompletedRows() must check them)
+	void markRowsChanged(int rowIndex, int count, bool mayBeCompleted);
+
+	// move the grid & bitboard storage of count rows (see moveRows()), without
+	//   touching the column masks or the surface profile.
+	void moveRowStorage(int sourceRowIndex, int targetRowIndex, int count);
+
+	// rebuild the column mask bits of count rows starting at rowIndex from the row masks
+	void syncColumns(int rowIndex, int count);
+
+	// bring the cached profile up to date: recompute the stale columns
+	//   (or the whole profile when most of them are stale)
+	void refreshProfile() const;
+
+	// recompute the cached profile of one column from its mask, and adjust
+	//   the board totals (bumpiness & wells also depend on the neighbours).
+	void updateColumnProfile(int columnIndex) const;
+
+	// recompute the cached well depth of one column, and adjust the well total
+	void updateWellDepth(int columnIndex) const;
+
+	// recompute the whole cached profile from the column masks
+	void rebuildProfile() const;
+
+	// when GAMEBOARD_VERIFY_PROFILE is defined: assert that isProfileConsistent()
+	void verifyProfile() const;
+
+	// return the hash key of content at column x (0 for EMPTY_BLOCK)
+	static std::uint64_t cellKey(int x, Cell content);
+
+	// return the contribution of a row with a given row hash at rowIndex to the
+	//   board hash (0 for an empty row)
+	static std::uint64_t rowKey(int rowIndex, std::uint64_t rowHash);
+
+	// fold the rows changed since the last call back into the board hash
+	void refreshHash() const;
+
 	// return a bool indicating if a given row is full (no EMPTY_BLOCK in the row)
 	bool isRowCompleted(int rowIndex) const;	
 	
@@ -130,10 +365,22 @@ private:
 	void removeRow(int rowIndex);		
 								
 	// given a vector of row indices, remove them 
-	//   (iterate through the vector and and call removeRow()
-	//   on each row index). 
+	//   (build a row index mask and compactRows() it, so the
+	//   board is shifted once no matter how many rows are removed).
 	void removeRows(std::vector<int> rowIndices); 
 
+	// remove a set of rows in one stable bottom-up pass.
+	//   Each run of surviving rows is moved down (by the number of removed
+	//   rows beneath it) with a single block move, then the rows
+	//   vacated at the top are filled with EMPTY_BLOCK.
+	//   The column masks drop the removed bits (a couple of bit operations
+	//   per column & removed row) and every column is marked stale.
+	void compactRows(RowIndexMask removedRows);
+
+	// move a block of count rows starting at sourceRowIndex so that it starts
+	//   at targetRowIndex (the source and target blocks may overlap).
+	void moveRows(int sourceRowIndex, int targetRowIndex, int count);
+
 	// fill a given grid row with specified content
 	void fillRow(int rowIndex, int content);	
 
@@ -143,16 +390,59 @@ private:
 
     // MEMBER VARIABLES -------------------------------------------------
    
-	// the gameboard - a grid of X and Y offsets.  
-	//  ([0][0] is top left, [MAX_X][MAX_Y] is bottom right) 
-	int grid[MAX_X][MAX_Y];				 
+	// the gameboard - a grid of rows, stored row-major ([y][x]).
+	//  ([0][0] is top left, [MAX_Y][MAX_X] is bottom right) 
+	//  Rows are always filled and copied as whole ROW_STRIDE blocks
+	//  (the padding past MAX_X is never read through the accessors).
+	alignas(64) Cell grid[MAX_Y][ROW_STRIDE];
+	// the occupancy bitboard - one mask per row, kept in sync with grid.
+	//  (rows[y] == FULL_ROW means row y is completed)
+	RowMask rows[MAX_Y];
+	// the walled bitboard for fits(): CEILING_ROWS open rows, then one WalledRow per
+	//  board row (kept in sync with rows), then FLOOR_ROWS solid rows.
+	WalledRow walledRows[CEILING_ROWS + MAX_Y + FLOOR_ROWS];
+	// rows changed since the last takeDirtyRows()
+	RowIndexMask dirtyRows = 0;
+	// rows that may have been completed since the last clearCompletedRows()
+	RowIndexMask unCheckedRows = 0;
+
+	// per row content hashes (the XOR of cellKey() for every cell in the row), kept in sync with grid.
+	std::uint64_t rowHashes[MAX_Y];
+	// the board hash (the XOR of every row's rowKey()), refreshed on demand (see refreshHash())
+	mutable RowIndexMask unHashedRows = 0;	// rows changed since the last refresh
+	mutable std::uint64_t rowKeys[MAX_Y];	// the rowKey() of each row, as folded into hash
+	mutable std::uint64_t hash = 0;
+	// per column occupancy (bit y set = grid[x][y] has content), kept in sync with grid.
+	RowIndexMask columns[MAX_X];
+	// the surface profile cache (see getColumnHeight() & friends)
+	//  (mutable: the const queries refresh it on demand, see refreshProfile())
+	mutable RowMask staleColumns = 0;	// columns changed since the last refresh (bit x = column x)
+	mutable int columnHeights[MAX_X];
+	mutable int columnHoles[MAX_X];
+	mutable int wellDepths[MAX_X];
+	mutable int aggregateHeight = 0;
+	mutable int holeCount = 0;
+	mutable int bumpiness = 0;
+	mutable int wellDepthSum = 0;
 	// the gameboard offset to spawn a new tetromino at.
-	const Point spawnLoc {MAX_X/2, 0};		
+	//   (SRS: 3 wide shapes spawn centered, rounded left - the I & O in the middle -
+	//    with the whole shape on the board, its top row at row 0)
+	const Point spawnLoc {(MAX_X - 1)/2, 1};		
 
 	// FRIENDS
 // for testing purposes (allows TestSuite to access private members of this class)
 	friend class TestSuite;				
 };
 
-#endif /* GAMEBOARD_H */
+// the standard gameboard (10 x 19)
+typedef BasicGameboard<10, 19> Gameboard;
+// guideline board: 10 x 20 visible rows with a 20 row hidden buffer above them
+typedef BasicGameboard<10, 40> GuidelineGameboard;
+// narrow board used for training
+typedef BasicGameboard<4, 20> TrainingGameboard;
+// extra wide board
+typedef BasicGameboard<40, 20> MegaGameboard;
 
+#include "Gameboard.inl"
+
+#endif /* GAMEBOARD_H */
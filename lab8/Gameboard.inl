@@ -0,0 +1,732 @@
+// Member function definitions for BasicGameboard<WIDTH, HEIGHT>.
+// Included at the bottom of Gameboard.h (a template's definitions must be
+// visible wherever it is instantiated).
+
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <assert.h>
+
+
+	// MEMBER FUNCTIONS
+
+
+	// constructor - empty() the grid
+	template <int WIDTH, int HEIGHT>
+	BasicGameboard<WIDTH, HEIGHT>::BasicGameboard() {
+		empty();
+	}
+
+	// return the content at a given point
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getContent(Point pt) const {
+		return grid[pt.getY()][pt.getX()];
+	}
+	// return the content at an x,y grid loc
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getContent(int x, int y) const {
+		return grid[y][x];
+	}
+
+	// set the content at a given point
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::setContent(Point pt, int content) {
+		setContent(pt.getX(), pt.getY(), content);
+	}
+	// set the content at an x,y grid loc
+	//   (the occupancy bit for x is set or cleared to match the content)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::setContent(int x, int y, int content) {
+		Cell oldContent = grid[y][x];
+		grid[y][x] = static_cast<Cell>(content);
+		rowHashes[y] ^= cellKey(x, oldContent) ^ cellKey(x, grid[y][x]);
+		RowIndexMask column = columns[x];
+		if (content == EMPTY_BLOCK) {
+			rows[y] &= static_cast<RowMask>(~columnBit(x));
+			columns[x] &= ~(RowIndexMask(1) << y);
+		}
+		else {
+			rows[y] |= columnBit(x);
+			columns[x] |= (RowIndexMask(1) << y);
+		}
+		markRowsChanged(y, 1, content != EMPTY_BLOCK);
+		// recoloring an occupied (or re-emptying an empty) cell leaves the profile as is
+		if (columns[x] != column) {
+			staleColumns |= columnBit(x);
+		}
+		verifyProfile();
+	}
+
+	// set the content for an array of grid locs
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::setContent(const std::vector<Point>& locs, int content) {
+		setContent(locs.data(), static_cast<int>(locs.size()), 0, 0, content);
+	}
+
+	// set the content for count grid locs, each moved by [xOffset, yOffset]
+	//   (the locs are read in place: no copies, no allocations)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::setContent(const Point* locs, int count, int xOffset, int yOffset, int content) {
+		for (int i = 0; i < count; i++) {
+			setContent(locs[i].getX() + xOffset, locs[i].getY() + yOffset, content);
+		}
+	}
+
+	// set the content for a fixed size array of grid locs, each moved by offset
+	template <int WIDTH, int HEIGHT>
+	template <std::size_t N>
+	void BasicGameboard<WIDTH, HEIGHT>::setContent(const std::array<Point, N>& locs, Point offset, int content) {
+		setContent(locs.data(), static_cast<int>(N), offset.getX(), offset.getY(), content);
+	}
+
+
+	// return true if the content at ALL (valid) points is empty
+	//   *** IMPORTANT NOTE: invalid x,y values can be passed to this method.
+	//   Invalid meaning: outside the bounds of the grid.
+	//   * ONLY TEST VALID POINTS (disregard the others - and ensure you
+	//   don't use them to index into the grid).  Testing invalid points
+	//   would likely result in an out of bounds error or segmentation fault!
+	//   If no points are valid, return true
+	//   Each valid loc is a single AND against its row's occupancy mask.
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::areLocsEmpty(const std::vector<Point>& locs) const {
+		return areLocsEmpty(locs.data(), static_cast<int>(locs.size()), 0, 0);
+	}
+
+	// same as areLocsEmpty(locs), for count locs each moved by [xOffset, yOffset]
+	//   (the locs are read in place: no copies, no allocations)
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::areLocsEmpty(const Point* locs, int count, int xOffset, int yOffset) const {
+		for (int i = 0; i < count; i++) {
+			int x = locs[i].getX() + xOffset;
+			int y = locs[i].getY() + yOffset;
+			if (x >= 0 && x < MAX_X && y >= 0 && y < MAX_Y) {
+				if (rows[y] & columnBit(x)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// same as areLocsEmpty(locs), for a fixed size array of locs each moved by offset
+	template <int WIDTH, int HEIGHT>
+	template <std::size_t N>
+	bool BasicGameboard<WIDTH, HEIGHT>::areLocsEmpty(const std::array<Point, N>& locs, Point offset) const {
+		return areLocsEmpty(locs.data(), static_cast<int>(N), offset.getX(), offset.getY());
+	}
+
+	// return true if a shape with its origin at [x,y] fits: all of its blocks are within
+	//   the left, right & lower borders, and none of them overlaps content.
+	//   (the area above the board is open, just like isShapeWithinBorders() in TetrisGame)
+	//   The collision kernel: one shifted AND per shape row against the walled
+	//   bitboard, with no branches. Positions too far out are clamped: a shape clamped
+	//   against a side lands (at least partly) in the wall, one clamped below the board
+	//   lands in the floor, and one clamped above it stays in the (identical) open rows.
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::fits(const ShapeMask& shape, int x, int y) const {
+		int shift = std::min(std::max(x + shape.left + WALL_BITS, 0), WALL_BITS + MAX_X);
+		int row = std::min(std::max(y + shape.top + CEILING_ROWS, 0), CEILING_ROWS + MAX_Y);
+		const WalledRow* stack = &walledRows[row];
+		WalledRow hits = (stack[0] & (WalledRow(shape.rows[0]) << shift))
+			| (stack[1] & (WalledRow(shape.rows[1]) << shift))
+			| (stack[2] & (WalledRow(shape.rows[2]) << shift))
+			| (stack[3] & (WalledRow(shape.rows[3]) << shift));
+		return hits == 0;
+	}
+	// same as fits(shape, x, y), with the origin at loc
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::fits(const ShapeMask& shape, Point loc) const {
+		return fits(shape, loc.getX(), loc.getY());
+	}
+
+	// return how many rows a shape with its origin at [x,y] can fall before it
+	//   lands on content or the floor (0 if it can't move down at all).
+	//   The shape must fit at [x,y]. O(1): one scan (a shift & count trailing
+	//   zeros) of the column mask under the lowest block of each shape column.
+	//   Use it for hard drops and to place the ghost piece.
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getDropDistance(const ShapeMask& shape, int x, int y) const {
+		assert(fits(shape, x, y));
+		int distance = MAX_Y;
+		for (int j = 0; j < ShapeMask::COLUMNS; j++) {
+			if (shape.bottoms[j] < 0) {
+				continue;
+			}
+			int blockRow = y + shape.top + shape.bottoms[j];
+			int start = std::max(blockRow + 1, 0);	// the first row under the block (on the board)
+			std::uint64_t below = (start < MAX_Y) ? (std::uint64_t(columns[x + shape.left + j]) >> start) : 0;
+			int landing = (below != 0) ? start + countTrailingZeros(below) : MAX_Y;	// the first occupied row (or the floor)
+			distance = std::min(distance, landing - blockRow - 1);
+		}
+		return distance;
+	}
+	// same as getDropDistance(shape, x, y), with the origin at loc
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getDropDistance(const ShapeMask& shape, Point loc) const {
+		return getDropDistance(shape, loc.getX(), loc.getY());
+	}
+
+	// return the occupancy bitmask of a given row (bit x set = grid[x][rowIndex] has content)
+	template <int WIDTH, int HEIGHT>
+	typename BasicGameboard<WIDTH, HEIGHT>::RowMask BasicGameboard<WIDTH, HEIGHT>::getRowMask(int rowIndex) const {
+		return rows[rowIndex];
+	}
+
+	// return a 64 bit hash of an occupancy given as row masks rows[0..MAX_Y - 1] (eg: a
+	//   board's getRowMask()s, or a search's copy of them) - unlike getHash(), colors don't
+	//   count and nothing is cached: for search code that keeps boards as bare row masks
+	//   (the rows are folded in 4 at a time, through the splitmix64 finalizer)
+	template <int WIDTH, int HEIGHT>
+	std::uint64_t BasicGameboard<WIDTH, HEIGHT>::getOccupancyHash(const RowMask* rows) {
+		std::uint64_t hash = 0;
+		for (int y = 0; y < MAX_Y; y++) {
+			hash = (hash << 16 | hash >> 48) ^ rows[y];
+			if (y % 4 == 3) {
+				hash = mix64(hash);
+			}
+		}
+		return mix64(hash);
+	}
+
+	// return the # of occupied blocks in a given row
+	//   (a popcount of the row's occupancy mask - always up to date)
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getRowFillCount(int rowIndex) const {
+		return popCount(rows[rowIndex]);
+	}
+
+	// return the set of rows whose content changed since the last call
+	//   (bit y set = row y changed), and start tracking afresh.
+	template <int WIDTH, int HEIGHT>
+	typename BasicGameboard<WIDTH, HEIGHT>::RowIndexMask BasicGameboard<WIDTH, HEIGHT>::takeDirtyRows() {
+		RowIndexMask changedRows = dirtyRows;
+		dirtyRows = 0;
+		return changedRows;
+	}
+
+	// return the occupancy bitmask of a given column (bit y set = grid[columnIndex][y] has content)
+	template <int WIDTH, int HEIGHT>
+	typename BasicGameboard<WIDTH, HEIGHT>::RowIndexMask BasicGameboard<WIDTH, HEIGHT>::getColumnMask(int columnIndex) const {
+		return columns[columnIndex];
+	}
+
+	// return the height of a column: the # of rows from the bottom of the board
+	//   up to (and including) its highest block. 0 for an empty column.
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getColumnHeight(int columnIndex) const {
+		refreshProfile();
+		return columnHeights[columnIndex];
+	}
+
+	// return the # of holes in a column (empty cells with a block somewhere above them)
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getColumnHoles(int columnIndex) const {
+		refreshProfile();
+		return columnHoles[columnIndex];
+	}
+
+	// return the depth of the well at a column: how far the column is below the lower
+	//   of its two neighbours (the walls count as full height), or 0 if it isn't below both.
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getWellDepth(int columnIndex) const {
+		refreshProfile();
+		return wellDepths[columnIndex];
+	}
+
+	// return the sum of all column heights
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getAggregateHeight() const {
+		refreshProfile();
+		return aggregateHeight;
+	}
+
+	// return the # of holes on the board
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getHoleCount() const {
+		refreshProfile();
+		return holeCount;
+	}
+
+	// return the sum of the height differences between neighbouring columns
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getBumpiness() const {
+		refreshProfile();
+		return bumpiness;
+	}
+
+	// return the sum of all well depths
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::getWellDepthSum() const {
+		refreshProfile();
+		return wellDepthSum;
+	}
+
+	// return a 64 bit hash of the board content (every cell's occupancy & color)
+	//   Kept up to date incrementally: O(1) plus one mix per row changed since the last
+	//   call. The keys are fixed (not random), so a hash is the same from run to run and
+	//   can be stored. An empty board hashes to 0.
+	template <int WIDTH, int HEIGHT>
+	std::uint64_t BasicGameboard<WIDTH, HEIGHT>::getHash() const {
+		refreshHash();
+		return hash;
+	}
+
+	// recompute the hash from the grid and return true if it matches the
+	//   cached one (for debugging - this is a full O(board) scan).
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::isHashConsistent() const {
+		refreshHash();
+		std::uint64_t boardHash = 0;
+		for (int y = 0; y < MAX_Y; y++) {
+			std::uint64_t rowHash = 0;
+			for (int x = 0; x < MAX_X; x++) {
+				rowHash ^= cellKey(x, static_cast<Cell>(getContent(x, y)));
+			}
+			if (rowHash != rowHashes[y]) {
+				return false;
+			}
+			boardHash ^= rowKey(y, rowHash);
+		}
+		return boardHash == hash;
+	}
+
+	// recompute the whole profile from the grid and return true if it matches the
+	//   cached one (for debugging - this is a full O(board) scan).
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::isProfileConsistent() const {
+		refreshProfile();
+		int heights[MAX_X];
+		int totalHeight = 0;
+		int totalHoles = 0;
+		for (int x = 0; x < MAX_X; x++) {
+			RowIndexMask column = 0;
+			heights[x] = 0;
+			int holes = 0;
+			for (int y = MAX_Y - 1; y >= 0; y--) {
+				if (getContent(x, y) != EMPTY_BLOCK) {
+					column |= (RowIndexMask(1) << y);
+					heights[x] = MAX_Y - y;
+				}
+			}
+			for (int y = MAX_Y - heights[x]; y < MAX_Y; y++) {
+				if (getContent(x, y) == EMPTY_BLOCK) {
+					holes++;
+				}
+			}
+			if (column != columns[x] || heights[x] != columnHeights[x] || holes != columnHoles[x]) {
+				return false;
+			}
+			totalHeight += heights[x];
+			totalHoles += holes;
+		}
+
+		int totalBumpiness = 0;
+		int totalWells = 0;
+		for (int x = 0; x < MAX_X; x++) {
+			int left = (x > 0) ? heights[x - 1] : MAX_Y;
+			int right = (x < MAX_X - 1) ? heights[x + 1] : MAX_Y;
+			int depth = std::max(0, std::min(left, right) - heights[x]);
+			if (depth != wellDepths[x]) {
+				return false;
+			}
+			totalWells += depth;
+			if (x > 0) {
+				totalBumpiness += std::abs(heights[x] - heights[x - 1]);
+			}
+		}
+
+		return totalHeight == aggregateHeight && totalHoles == holeCount
+			&& totalBumpiness == bumpiness && totalWells == wellDepthSum;
+	}
+
+	// removes all completed rows from the board
+	//   use clearCompletedRows()
+	//   return the # of completed rows removed
+	template <int WIDTH, int HEIGHT>
+	int BasicGameboard<WIDTH, HEIGHT>::removeCompletedRows() {
+		return popCount(clearCompletedRows());
+	}
+
+	// find all completed rows and remove them in a single stable pass
+	//   (see compactRows()).
+	//   Only rows that were filled since the previous call can have become
+	//   completed, so only those are checked: after locking a tetromino this
+	//   costs O(rows touched), not O(board).
+	//   return the set of cleared row indices (bit y set = row y was cleared)
+	template <int WIDTH, int HEIGHT>
+	typename BasicGameboard<WIDTH, HEIGHT>::RowIndexMask BasicGameboard<WIDTH, HEIGHT>::clearCompletedRows() {
+		RowIndexMask completedRows = 0;
+		for (RowIndexMask pending = unCheckedRows; pending != 0; pending &= pending - 1) {
+			int y = countTrailingZeros(pending);
+			if (isRowCompleted(y)) {
+				completedRows |= (RowIndexMask(1) << y);
+			}
+		}
+		compactRows(completedRows);
+		// survivors were not completed, and vacated rows are empty
+		unCheckedRows = 0;
+		return completedRows;
+	}
+
+	// fill the board with EMPTY_BLOCK 
+	//   (the rows are contiguous, so the grid and bitboard are each cleared
+	//   with a single block fill rather than a fillRow() per row)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::empty() {
+		std::memset(grid, static_cast<Cell>(EMPTY_BLOCK), sizeof(grid));
+		std::memset(rows, 0, sizeof(rows));
+		for (int y = 0; y < CEILING_ROWS; y++) {
+			walledRows[y] = WALLS;
+		}
+		for (int y = CEILING_ROWS + MAX_Y; y < CEILING_ROWS + MAX_Y + FLOOR_ROWS; y++) {
+			walledRows[y] = ~WalledRow(0);
+		}
+		std::memset(columns, 0, sizeof(columns));
+		std::memset(rowHashes, 0, sizeof(rowHashes));
+		std::memset(rowKeys, 0, sizeof(rowKeys));
+		hash = 0;
+		markRowsChanged(0, MAX_Y, false);
+		unCheckedRows = 0;
+		unHashedRows = 0;
+		// an empty board has a flat profile: no heights, holes, bumps or wells
+		staleColumns = 0;
+		std::memset(columnHeights, 0, sizeof(columnHeights));
+		std::memset(columnHoles, 0, sizeof(columnHoles));
+		std::memset(wellDepths, 0, sizeof(wellDepths));
+		aggregateHeight = 0;
+		holeCount = 0;
+		bumpiness = 0;
+		wellDepthSum = 0;
+		verifyProfile();
+	}
+
+	// getter for the spawnLoc for new blocks
+	template <int WIDTH, int HEIGHT>
+	Point BasicGameboard<WIDTH, HEIGHT>::getSpawnLoc() const {
+		return spawnLoc;
+	}
+
+	// print the grid contents to the console (for debugging purposes)
+	//   use std::setw(2) to space the contents out (#include <iomanip>).
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::printToConsole() const {
+
+	}
+
+	// return the occupancy bit for column x
+	template <int WIDTH, int HEIGHT>
+	typename BasicGameboard<WIDTH, HEIGHT>::RowMask BasicGameboard<WIDTH, HEIGHT>::columnBit(int x) {
+		return static_cast<RowMask>(RowMask(1) << x);
+	}
+
+	// record that a block of count rows starting at rowIndex has changed.
+	//   mayBeCompleted: the rows may now be completed (clearCompletedRows() must check them)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::markRowsChanged(int rowIndex, int count, bool mayBeCompleted) {
+		RowIndexMask changed = (count >= MAX_Y) ? ALL_ROWS
+			: ((RowIndexMask(1) << count) - 1);
+		changed = static_cast<RowIndexMask>(changed << rowIndex) & ALL_ROWS;	// (no bits past the last row)
+		dirtyRows |= changed;
+		unHashedRows |= changed;
+		for (int y = rowIndex; y < rowIndex + count; y++) {
+			walledRows[CEILING_ROWS + y] = WALLS | (WalledRow(rows[y]) << WALL_BITS);
+		}
+		if (mayBeCompleted) {
+			unCheckedRows |= changed;
+		}
+	}
+
+	// move the grid & bitboard storage of count rows (see moveRows()), without
+	//   touching the column masks or the surface profile.
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::moveRowStorage(int sourceRowIndex, int targetRowIndex, int count) {
+		std::memmove(grid[targetRowIndex], grid[sourceRowIndex], count * ROW_STRIDE);
+		std::memmove(&rows[targetRowIndex], &rows[sourceRowIndex], count * sizeof(RowMask));
+		std::memmove(&rowHashes[targetRowIndex], &rowHashes[sourceRowIndex], count * sizeof(std::uint64_t));
+		markRowsChanged(targetRowIndex, count, true);
+	}
+
+	// rebuild the column mask bits of count rows starting at rowIndex from the row masks
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::syncColumns(int rowIndex, int count) {
+		for (int x = 0; x < MAX_X; x++) {
+			RowIndexMask column = columns[x];
+			for (int y = rowIndex; y < rowIndex + count; y++) {
+				RowIndexMask bit = RowIndexMask(1) << y;
+				column = (rows[y] & columnBit(x)) ? (column | bit) : (column & ~bit);
+			}
+			columns[x] = column;
+		}
+	}
+
+	// recompute the cached profile of one column from its mask, and adjust
+	//   the board totals (bumpiness & wells also depend on the neighbours).
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::updateColumnProfile(int columnIndex) const {
+		RowIndexMask column = columns[columnIndex];
+		int oldHeight = columnHeights[columnIndex];
+		int height = (column != 0) ? MAX_Y - countTrailingZeros(column) : 0;
+		int holes = height - popCount(column);
+
+		holeCount += holes - columnHoles[columnIndex];
+		columnHoles[columnIndex] = holes;
+		if (height == oldHeight) {
+			return;
+		}
+
+		aggregateHeight += height - oldHeight;
+		if (columnIndex > 0) {
+			int left = columnHeights[columnIndex - 1];
+			bumpiness += std::abs(height - left) - std::abs(oldHeight - left);
+		}
+		if (columnIndex < MAX_X - 1) {
+			int right = columnHeights[columnIndex + 1];
+			bumpiness += std::abs(height - right) - std::abs(oldHeight - right);
+		}
+		columnHeights[columnIndex] = height;
+
+		updateWellDepth(columnIndex);
+		if (columnIndex > 0) {
+			updateWellDepth(columnIndex - 1);
+		}
+		if (columnIndex < MAX_X - 1) {
+			updateWellDepth(columnIndex + 1);
+		}
+	}
+
+	// recompute the cached well depth of one column, and adjust the well total
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::updateWellDepth(int columnIndex) const {
+		int left = (columnIndex > 0) ? columnHeights[columnIndex - 1] : MAX_Y;
+		int right = (columnIndex < MAX_X - 1) ? columnHeights[columnIndex + 1] : MAX_Y;
+		int depth = std::max(0, std::min(left, right) - columnHeights[columnIndex]);
+		wellDepthSum += depth - wellDepths[columnIndex];
+		wellDepths[columnIndex] = depth;
+	}
+
+	// bring the cached profile up to date: recompute the stale columns
+	//   (or the whole profile when most of them are stale)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::refreshProfile() const {
+		if (staleColumns == 0) {
+			return;
+		}
+		if (popCount(staleColumns) > MAX_X / 2) {
+			rebuildProfile();
+		}
+		else {
+			for (RowMask pending = staleColumns; pending != 0; pending &= pending - 1) {
+				updateColumnProfile(countTrailingZeros(pending));
+			}
+		}
+		staleColumns = 0;
+	}
+
+	// recompute the whole cached profile from the column masks
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::rebuildProfile() const {
+		aggregateHeight = 0;
+		holeCount = 0;
+		for (int x = 0; x < MAX_X; x++) {
+			RowIndexMask column = columns[x];
+			columnHeights[x] = (column != 0) ? MAX_Y - countTrailingZeros(column) : 0;
+			columnHoles[x] = columnHeights[x] - popCount(column);
+			aggregateHeight += columnHeights[x];
+			holeCount += columnHoles[x];
+		}
+		bumpiness = 0;
+		wellDepthSum = 0;
+		for (int x = 0; x < MAX_X; x++) {
+			wellDepths[x] = 0;
+			updateWellDepth(x);
+			if (x > 0) {
+				bumpiness += std::abs(columnHeights[x] - columnHeights[x - 1]);
+			}
+		}
+	}
+
+	// return the hash key of content at column x (0 for EMPTY_BLOCK)
+	template <int WIDTH, int HEIGHT>
+	std::uint64_t BasicGameboard<WIDTH, HEIGHT>::cellKey(int x, Cell content) {
+		static constexpr GameboardCellKeys<MAX_X> CELL_KEYS{};
+		if (content >= 0 && content < CELL_KEYS.CONTENTS) {
+			return CELL_KEYS.keys[x][content];
+		}
+		return (content == EMPTY_BLOCK) ? 0 : GameboardCellKeys<MAX_X>::key(x, content);
+	}
+
+	// return the contribution of a row with a given row hash at rowIndex to the
+	//   board hash (0 for an empty row)
+	template <int WIDTH, int HEIGHT>
+	std::uint64_t BasicGameboard<WIDTH, HEIGHT>::rowKey(int rowIndex, std::uint64_t rowHash) {
+		if (rowHash == 0) {
+			return 0;
+		}
+		return mix64(rowHash + static_cast<std::uint64_t>(rowIndex + 1) * 0xD6E8FEB86659FD93ULL);
+	}
+
+	// fold the rows changed since the last call back into the board hash
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::refreshHash() const {
+		assert((unHashedRows & ~ALL_ROWS) == 0);	// (only the board's rows have keys)
+		for (RowIndexMask pending = unHashedRows; pending != 0; pending &= pending - 1) {
+			int y = countTrailingZeros(pending);
+			std::uint64_t key = rowKey(y, rowHashes[y]);
+			hash ^= rowKeys[y] ^ key;
+			rowKeys[y] = key;
+		}
+		unHashedRows = 0;
+	}
+
+	// when GAMEBOARD_VERIFY_PROFILE is defined: assert that isProfileConsistent()
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::verifyProfile() const {
+#ifdef GAMEBOARD_VERIFY_PROFILE
+		assert(isProfileConsistent());
+#endif
+	}
+
+	// return a bool indicating if a given row is full (no EMPTY_BLOCK in the row)
+	//   (a single compare against the row's occupancy mask)
+	template <int WIDTH, int HEIGHT>
+	bool BasicGameboard<WIDTH, HEIGHT>::isRowCompleted(int rowIndex) const {
+		return rows[rowIndex] == FULL_ROW;
+	}
+
+	// scan the board for completed rows.
+	//   Iterate through grid rows and use isRowCompleted(rowIndex)
+	//   return a vector of completed row indices.
+	template <int WIDTH, int HEIGHT>
+	std::vector<int> BasicGameboard<WIDTH, HEIGHT>::getCompletedRowIndices() const {
+		std::vector<int> fullRows;
+
+		for (int y = 0; y < MAX_Y; y++) {
+			if (isRowCompleted(y)) {
+				fullRows.push_back(y);
+			}				
+		}
+		return fullRows;
+	}
+
+	// In gameplay, when a full row is completed (filled with content)
+	// it gets "removed".  To be exact, the row itself is not removed
+	// but the content from the row above it is copied into it.
+	// This continues all the way up the grid until the first row
+	// is copied into the second row.  Finally, the first row is 
+	// filled with EMPTY_BLOCK
+	// given a row index:
+	//   1) Starting at rowIndex, copy each row above the removed
+	//     row "one-row-downwards" in the grid.
+	//     (loop from y=rowIndex down to 0, and copyRowIntoRow(y-1, y)).
+	//   2) call fillRow() on the first row (and place EMPTY_BLOCKs in it).
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::removeRow(int rowIndex) {
+		for (int y = rowIndex; y > 0; y--) {
+			copyRowIntoRow(y - 1, y);
+			//for (int x = 0; x < MAX_X; x++) {
+				
+			//}
+		}
+		fillRow(0, EMPTY_BLOCK);
+	}
+
+	// given a vector of row indices, remove them 
+	//   (build a row index mask and compactRows() it, so the
+	//   board is shifted once no matter how many rows are removed).
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::removeRows(std::vector<int> rowIndices) {
+		RowIndexMask removedRows = 0;
+		for (std::size_t i = 0; i < rowIndices.size(); i++) {
+			removedRows |= (RowIndexMask(1) << rowIndices[i]);
+		}
+		compactRows(removedRows);
+	}
+
+	// remove a set of rows in one stable bottom-up pass.
+	//   Each run of surviving rows is moved down (by the number of removed
+	//   rows beneath it) with a single block move, then the rows
+	//   vacated at the top are filled with EMPTY_BLOCK.
+	//   The column masks drop the removed bits (a couple of bit operations
+	//   per column & removed row) and every column is marked stale.
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::compactRows(RowIndexMask removedRows) {
+		if (removedRows == 0) {
+			return;
+		}
+
+		int shift = 0;	// # of removed rows below the current row
+		int y = MAX_Y - 1;
+		while (y >= 0) {
+			if (removedRows & (RowIndexMask(1) << y)) {
+				shift++;
+				y--;
+				continue;
+			}
+			// find the run of surviving rows [y+1 .. bottom]
+			int bottom = y;
+			while (y >= 0 && !(removedRows & (RowIndexMask(1) << y))) {
+				y--;
+			}
+			if (shift > 0) {
+				moveRowStorage(y + 1, y + 1 + shift, bottom - y);
+			}
+		}
+
+		std::memset(grid, static_cast<Cell>(EMPTY_BLOCK), shift * ROW_STRIDE);
+		std::memset(rows, 0, shift * sizeof(RowMask));
+		std::memset(rowHashes, 0, shift * sizeof(std::uint64_t));
+		markRowsChanged(0, shift, false);
+
+		// rows above a removed row move down one (their index goes up by one)
+		for (RowIndexMask pending = removedRows; pending != 0; pending &= pending - 1) {
+			int removed = countTrailingZeros(pending);
+			RowIndexMask above = (RowIndexMask(1) << removed) - 1;
+			RowIndexMask aboveAndRemoved = (above << 1) | 1;
+			for (int x = 0; x < MAX_X; x++) {
+				columns[x] = (columns[x] & ~aboveAndRemoved) | ((columns[x] & above) << 1);
+			}
+		}
+		staleColumns = FULL_ROW;
+		verifyProfile();
+	}
+
+	// move a block of count rows starting at sourceRowIndex so that it starts
+	//   at targetRowIndex (the source and target blocks may overlap).
+	//   (rows are contiguous, so this is a single block move of the grid and bitboard)
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::moveRows(int sourceRowIndex, int targetRowIndex, int count) {
+		moveRowStorage(sourceRowIndex, targetRowIndex, count);
+		syncColumns(targetRowIndex, count);
+		staleColumns = FULL_ROW;
+		verifyProfile();
+	}
+
+	// fill a given grid row with specified content
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::fillRow(int rowIndex, int content) {
+		std::memset(grid[rowIndex], static_cast<Cell>(content), ROW_STRIDE);
+		rows[rowIndex] = (content == EMPTY_BLOCK) ? 0 : FULL_ROW;
+		rowHashes[rowIndex] = 0;
+		for (int x = 0; x < MAX_X; x++) {
+			rowHashes[rowIndex] ^= cellKey(x, static_cast<Cell>(content));
+		}
+		markRowsChanged(rowIndex, 1, content != EMPTY_BLOCK);
+		syncColumns(rowIndex, 1);
+		staleColumns = FULL_ROW;
+		verifyProfile();
+	}
+
+	// copy a source row's contents into a target row.
+	template <int WIDTH, int HEIGHT>
+	void BasicGameboard<WIDTH, HEIGHT>::copyRowIntoRow(int sourceRowIndex, int targetRowIndex) {
+		std::memcpy(grid[targetRowIndex], grid[sourceRowIndex], ROW_STRIDE);
+		rows[targetRowIndex] = rows[sourceRowIndex];
+		rowHashes[targetRowIndex] = rowHashes[sourceRowIndex];
+		markRowsChanged(targetRowIndex, 1, true);
+		syncColumns(targetRowIndex, 1);
+		staleColumns = FULL_ROW;
+		verifyProfile();
+	}
+
@@ -1,10 +1,11 @@
-#include <SFML/Graphics.hpp>
-#include <time.h>
-#include <iostream>
+#include <type_traits>
 #include "GridTetromino.h"
-#include "TetrisGame.h"
-#include "TestSuite.h"
 #include "Point.h"
+#include "BitUtils.h"
+
+// pieces are copied around freely (and stored by the million in searches): keep them cheap
+static_assert(std::is_trivially_copyable<GridTetromino>::value, "a GridTetromino copy must be a plain memcpy");
+static_assert(sizeof(PackedPiece) == 4, "a packed piece fits in 32 bits");
 
 // constructor, initialize gridLoc to 0,0
 GridTetromino::GridTetromino() {
@@ -51,3 +52,40 @@ std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const {
 	return mapedLocs;
 }
 
+// same as above, but fill a caller supplied array instead of building
+// a vector (no allocation - use this in the game loop).
+void GridTetromino::getBlockLocsMappedToGrid(std::array<Point, BLOCK_COUNT>& mappedLocs) const {
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		mappedLocs[i].setXY(gridLoc.getX() + blockLocs[i].getX(), gridLoc.getY() + blockLocs[i].getY());
+	}
+}
+
+
+// return a 64 bit hash key for this tetromino's shape, rotation and gridLoc.
+//   XOR it into a Gameboard hash to hash a whole game position
+//   (see TetrisGame::getPositionHash()).
+std::uint64_t GridTetromino::getHashKey() const {
+	std::uint64_t key = static_cast<std::uint64_t>(getShape());
+	key = (key << 2) | static_cast<std::uint64_t>(getRotation());
+	key = (key << 16) | static_cast<std::uint16_t>(gridLoc.getX());
+	key = (key << 16) | static_cast<std::uint16_t>(gridLoc.getY());
+	// a different salt from the gameboard's cell keys
+	return mix64(key + 0xA0761D6478BD642FULL);
+}
+
+// pack this tetromino's shape, rotation & gridLoc into a PackedPiece
+PackedPiece GridTetromino::pack() const {
+	PackedPiece piece;
+	piece.shape = static_cast<std::uint8_t>(getShape());
+	piece.rotation = static_cast<std::uint8_t>(getRotation());
+	piece.x = static_cast<std::int8_t>(gridLoc.getX());
+	piece.y = static_cast<std::int8_t>(gridLoc.getY());
+	return piece;
+}
+
+// set this tetromino's shape, rotation & gridLoc from a PackedPiece
+void GridTetromino::unpack(PackedPiece piece) {
+	setShape(static_cast<TetShape>(piece.shape));
+	setRotation(piece.rotation);
+	setGridLoc(piece.x, piece.y);
+}
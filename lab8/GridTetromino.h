@@ -9,8 +9,22 @@
 #ifndef GRIDTETROMINO_H
 #define GRIDTETROMINO_H
 
+#include <array>
+#include <cstdint>
 #include "Tetromino.h"
 
+// A whole grid tetromino in 4 bytes: its shape, rotation & grid loc.
+//   The blocks of every rotation state come from the rotation table, so that is
+//   all a piece is. Use it to keep large arrays of pieces (eg: for batched search),
+//   and GridTetromino::pack() / unpack() to convert.
+struct PackedPiece
+{
+	std::uint8_t shape;		// a TetShape
+	std::uint8_t rotation;	// # of clockwise quarter turns (0..3)
+	std::int8_t x;			// the grid loc
+	std::int8_t y;
+};
+
 class GridTetromino : public Tetromino
 {	
 public:
@@ -36,6 +50,21 @@ public:
 	// and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
 	std::vector<Point> getBlockLocsMappedToGrid() const;
 
+	// same as above, but fill a caller supplied array instead of building
+	// a vector (no allocation - use this in the game loop).
+	void getBlockLocsMappedToGrid(std::array<Point, BLOCK_COUNT>& mappedLocs) const;
+
+	// return a 64 bit hash key for this tetromino's shape, rotation and gridLoc.
+	//   XOR it into a Gameboard hash to hash a whole game position
+	//   (see TetrisGame::getPositionHash()).
+	std::uint64_t getHashKey() const;
+
+
+	// pack this tetromino's shape, rotation & gridLoc into a PackedPiece
+	PackedPiece pack() const;
+	// set this tetromino's shape, rotation & gridLoc from a PackedPiece
+	void unpack(PackedPiece piece);
+
 
 	// MEMBER VARIABLES
 private:
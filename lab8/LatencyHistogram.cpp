@@ -0,0 +1,86 @@
+#include "LatencyHistogram.h"
+#include "BitUtils.h"
+
+// count one value
+void LatencyHistogram::record(std::uint64_t nanos) {
+	counts[getBucket(nanos)]++;
+	count++;
+	sum += static_cast<double>(nanos);
+	if (nanos > max) {
+		max = nanos;
+	}
+}
+
+// add the counts of another histogram to this one
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+	for (int i = 0; i < BUCKETS; i++) {
+		counts[i] += other.counts[i];
+	}
+	count += other.count;
+	sum += other.sum;
+	if (other.max > max) {
+		max = other.max;
+	}
+}
+
+// forget every value
+void LatencyHistogram::clear() {
+	*this = LatencyHistogram();
+}
+
+// return the # of values recorded, their mean & the largest one
+std::uint64_t LatencyHistogram::getCount() const {
+	return count;
+}
+double LatencyHistogram::getMean() const {
+	return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+std::uint64_t LatencyHistogram::getMax() const {
+	return max;
+}
+
+// return the value below which percentile % of the values lie (0..100)
+//   (the upper bound of the bucket it falls in, but never more than getMax())
+std::uint64_t LatencyHistogram::getPercentile(double percentile) const {
+	if (count == 0) {
+		return 0;
+	}
+	// the rank of the value wanted (1..count)
+	std::uint64_t rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	std::uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		seen += counts[i];
+		if (seen >= rank) {
+			std::uint64_t value = getBucketMax(i);
+			return value < max ? value : max;
+		}
+	}
+	return max;
+}
+
+// return the bucket value is counted in
+//   values below SUB_BUCKETS get a bucket each; above that, each power of 2
+//   is split into SUB_BUCKETS equal buckets (the top SUB_BUCKET_BITS bits after
+//   the leading 1 pick the bucket)
+int LatencyHistogram::getBucket(std::uint64_t value) {
+	if (value < SUB_BUCKETS) {
+		return static_cast<int>(value);
+	}
+	int shift = highestSetBit(value) - SUB_BUCKET_BITS;
+	int subBucket = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+	return (shift + 1) * SUB_BUCKETS + subBucket;
+}
+
+// return the largest value counted in bucket
+std::uint64_t LatencyHistogram::getBucketMax(int bucket) {
+	if (bucket < SUB_BUCKETS) {
+		return static_cast<std::uint64_t>(bucket);
+	}
+	int shift = bucket / SUB_BUCKETS - 1;
+	std::uint64_t subBucket = static_cast<std::uint64_t>(bucket % SUB_BUCKETS);
+	std::uint64_t low = (SUB_BUCKETS + subBucket) << shift;
+	return low + ((std::uint64_t(1) << shift) - 1);
+}
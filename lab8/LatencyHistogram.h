@@ -0,0 +1,57 @@
+// A fixed size histogram of latencies (in nanoseconds) for percentile reports.
+// Functionality:
+//  - record() is O(1) & never allocates: values are counted in log-linear buckets
+//    (SUB_BUCKETS buckets per power of 2), so a percentile is within 1/SUB_BUCKETS
+//    (12.5%) of the true value - plenty for a throughput report.
+//  - Histograms merge by adding their buckets, so each thread can keep its own
+//    and the results are combined afterwards (no shared counters, no locks).
+//
+//  [expected .cpp size: ~ 80 lines]
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+
+class LatencyHistogram
+{
+public:
+	static const int SUB_BUCKET_BITS = 3;
+	static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;	// buckets per power of 2
+	static const int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	// count one value
+	void record(std::uint64_t nanos);
+
+	// add the counts of another histogram to this one
+	void merge(const LatencyHistogram& other);
+
+	// forget every value
+	void clear();
+
+	// return the # of values recorded, their mean & the largest one
+	std::uint64_t getCount() const;
+	double getMean() const;
+	std::uint64_t getMax() const;
+
+	// return the value below which percentile % of the values lie (0..100)
+	//   (the upper bound of the bucket it falls in, but never more than getMax())
+	std::uint64_t getPercentile(double percentile) const;
+
+	// MEMBER VARIABLES
+private:
+	// return the bucket value is counted in / the largest value counted in bucket
+	static int getBucket(std::uint64_t value);
+	static std::uint64_t getBucketMax(int bucket);
+
+	std::uint64_t counts[BUCKETS] = {};	// the # of values in each bucket
+	std::uint64_t count = 0;			// the # of values recorded
+	std::uint64_t max = 0;				// the largest value recorded
+	double sum = 0.0;					// the sum of the values recorded (for the mean)
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* LATENCYHISTOGRAM_H */
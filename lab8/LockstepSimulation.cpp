@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <assert.h>
+#include "LockstepSimulation.h"
+#ifdef LOCKSTEP_AVX2
+#include <immintrin.h>
+#endif
+
+const LockstepSimulation::WalledRow LockstepSimulation::WALLS;
+const LockstepSimulation::WalledRow LockstepSimulation::SOLID;
+
+// the ShapeMask of every piece (shape * 4 + rotation) split into flat 32 bit tables,
+//   so the AVX2 kernel can gather 8 lanes' masks at once: the offset of the mask's
+//   first column & row, and its 4 rows packed into one word (row i in byte i).
+struct LaneMaskTable
+{
+	static const int PIECES = TetShape::COUNT * TetrominoRotationTable::ROTATIONS;
+	std::int32_t lefts[PIECES];
+	std::int32_t tops[PIECES];
+	std::int32_t rows[PIECES];
+
+	constexpr LaneMaskTable(const TetrominoMaskTable& masks) : lefts(), tops(), rows() {
+		for (int piece = 0; piece < PIECES; piece++) {
+			const ShapeMask& mask = masks.masks[piece / TetrominoRotationTable::ROTATIONS][piece % TetrominoRotationTable::ROTATIONS];
+			lefts[piece] = mask.left;
+			tops[piece] = mask.top;
+			std::uint32_t packed = 0;
+			for (int row = 0; row < ShapeMask::ROWS; row++) {
+				packed |= std::uint32_t(mask.rows[row]) << (8 * row);
+			}
+			rows[piece] = static_cast<std::int32_t>(packed);
+		}
+	}
+};
+static constexpr LaneMaskTable LANE_MASKS{ Tetromino::MASK_TABLE };
+static_assert(ShapeMask::ROWS * 8 <= 32 && ShapeMask::COLUMNS <= 8, "a shape's rows must pack into one word");
+
+// return a view of lane # lane of simulation
+LockstepLane::LockstepLane(const LockstepSimulation& simulation, int lane) {
+	this->simulation = &simulation;
+	this->lane = lane;
+}
+
+// return true once a new shape could not be spawned
+bool LockstepLane::isGameOver() const {
+	return simulation->alive[lane] == 0;
+}
+
+// getters for the score, the total # of rows cleared & the # of shapes locked
+int LockstepLane::getScore() const {
+	return simulation->scores[lane];
+}
+int LockstepLane::getRowsCleared() const {
+	return simulation->rowsCleared[lane];
+}
+int LockstepLane::getPiecesLocked() const {
+	return simulation->piecesLocked[lane];
+}
+
+// return the falling tetromino (shape, rotation & grid loc)
+GridTetromino LockstepLane::getCurrentShape() const {
+	std::int32_t piece = simulation->pieces[lane];
+	PackedPiece packed;
+	packed.shape = static_cast<std::uint8_t>(piece / TetrominoRotationTable::ROTATIONS);
+	packed.rotation = static_cast<std::uint8_t>(piece % TetrominoRotationTable::ROTATIONS);
+	packed.x = static_cast<std::int8_t>(simulation->xs[lane]);
+	packed.y = static_cast<std::int8_t>(simulation->ys[lane]);
+	GridTetromino shape;
+	shape.unpack(packed);
+	return shape;
+}
+
+// return the occupancy bitmask of a given row (as Gameboard::getRowMask())
+Gameboard::RowMask LockstepLane::getRowMask(int rowIndex) const {
+	assert(rowIndex >= 0 && rowIndex < Gameboard::MAX_Y);
+	LockstepSimulation::WalledRow row =
+		simulation->walledRows[(LockstepSimulation::CEILING_ROWS + rowIndex) * simulation->paddedCount + lane];
+	return static_cast<Gameboard::RowMask>((row >> LockstepSimulation::WALL_BITS) & Gameboard::FULL_ROW);
+}
+
+// return the upcoming shapes & the hold slot
+const PieceQueue& LockstepLane::getPieceQueue() const {
+	return simulation->queues[lane];
+}
+
+// constructor, one lane per seed (each lane plays the game TetrisSimulation(seed) would)
+LockstepSimulation::LockstepSimulation(const std::vector<std::uint64_t>& seeds) {
+	Point spawnLoc = Gameboard().getSpawnLoc();
+	spawnX = spawnLoc.getX();
+	spawnY = spawnLoc.getY();
+	reset(seeds);
+}
+
+// start a new game in every lane, one lane per seed
+void LockstepSimulation::reset(const std::vector<std::uint64_t>& seeds) {
+	laneCount = static_cast<int>(seeds.size());
+	paddedCount = (laneCount + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK;
+
+	walledRows.assign(static_cast<std::size_t>(STACK_ROWS) * paddedCount, WALLS);
+	std::fill(walledRows.begin() + static_cast<std::size_t>(CEILING_ROWS + Gameboard::MAX_Y) * paddedCount,
+		walledRows.end(), SOLID);
+	for (std::vector<std::int32_t>* lanes : { &pieces, &xs, &ys, &alive, &scores, &rowsCleared, &piecesLocked,
+		&targetPieces, &targetXs, &targetYs, &fits, &flags, &pending }) {
+		lanes->assign(paddedCount, 0);
+	}
+	queues.assign(laneCount, PieceQueue());
+	for (int lane = 0; lane < laneCount; lane++) {
+		queues[lane].reset(PieceGenerator(seeds[lane]));
+		alive[lane] = -1;
+		flags[lane] = -1;
+	}
+	spawnLanes();
+}
+
+// return the # of lanes
+int LockstepSimulation::getLaneCount() const {
+	return laneCount;
+}
+
+// return the # of lanes still playing (not game over)
+int LockstepSimulation::getLiveLaneCount() const {
+	int count = 0;
+	for (int lane = 0; lane < laneCount; lane++) {
+		count += alive[lane] & 1;
+	}
+	return count;
+}
+
+// return a view of one lane
+LockstepLane LockstepSimulation::getLane(int lane) const {
+	assert(lane >= 0 && lane < laneCount);
+	return LockstepLane(*this, lane);
+}
+
+// apply a player action to the current shape of every live lane
+//   (as TetrisSimulation::applyAction() does for one game)
+//   return the # of lanes it did anything in
+int LockstepSimulation::applyAction(InputAction action) {
+	int live = getLiveLaneCount();
+	switch (action) {
+	case ACTION_LEFT:
+		return moveLanes(-1, 0);
+	case ACTION_RIGHT:
+		return moveLanes(1, 0);
+	case ACTION_SOFT_DROP:
+		moveLanes(0, 1);
+		for (int lane = 0; lane < paddedCount; lane++) {
+			scores[lane] += flags[lane] & TetrisSimulation::SOFT_DROP_SCORE;
+			flags[lane] = alive[lane] & ~flags[lane];	// (the lanes that couldn't move lock)
+		}
+		lockLanes();
+		return live;
+	case ACTION_HARD_DROP:
+		dropLanes();
+		std::copy(alive.begin(), alive.end(), flags.begin());
+		lockLanes();
+		return live;
+	case ACTION_ROTATE_CW:
+		return rotateLanes(1);
+	case ACTION_ROTATE_CCW:
+		return rotateLanes(3);
+	case ACTION_ROTATE_180:
+		return rotateLanes(2);
+	case ACTION_HOLD:
+		return holdLanes();
+	default:
+		return 0;
+	}
+}
+
+// one step of gravity for every live lane: move the current shape down a row,
+//   or lock it if it can't move (as TetrisSimulation::tick())
+void LockstepSimulation::tick() {
+	moveLanes(0, 1);
+	for (int lane = 0; lane < paddedCount; lane++) {
+		flags[lane] = alive[lane] & ~flags[lane];
+	}
+	lockLanes();
+}
+
+// return the name of the collision kernel compiled in ("avx2" or "scalar")
+const char* LockstepSimulation::getKernelName() {
+#ifdef LOCKSTEP_AVX2
+	return "avx2";
+#else
+	return "scalar";
+#endif
+}
+
+// for every lane with activeIn[lane] set, fitsOut[lane] = -1 if the piece pieceIn[lane]
+//   (shape * 4 + rotation) fits with its origin at [xIn[lane], yIn[lane]] on that lane's
+//   board, 0 if not (fitsOut is 0 for the inactive lanes)
+//   (the collision kernel, see Gameboard::fits() - blocks of LANE_BLOCK lanes with no
+//    active lane are skipped, the others are tested whole)
+//   Exactly Gameboard::fits(), with the board rows of a lane paddedCount words apart.
+void LockstepSimulation::fitsLanes(const std::int32_t* pieceIn, const std::int32_t* xIn, const std::int32_t* yIn,
+	const std::int32_t* activeIn, std::int32_t* fitsOut) const {
+	const int stride = paddedCount;
+	const WalledRow* board = walledRows.data();
+#ifdef LOCKSTEP_AVX2
+	const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i strides = _mm256_set1_epi32(stride);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	for (int lane = 0; lane < paddedCount; lane += LANE_BLOCK) {
+		__m256i active = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(activeIn + lane));
+		if (_mm256_testz_si256(active, active)) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(fitsOut + lane), zero);
+			continue;
+		}
+		__m256i piece = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pieceIn + lane));
+		__m256i left = _mm256_i32gather_epi32(LANE_MASKS.lefts, piece, 4);
+		__m256i top = _mm256_i32gather_epi32(LANE_MASKS.tops, piece, 4);
+		__m256i shape = _mm256_i32gather_epi32(LANE_MASKS.rows, piece, 4);
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xIn + lane));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yIn + lane));
+		__m256i shift = _mm256_add_epi32(_mm256_add_epi32(x, left), _mm256_set1_epi32(WALL_BITS));
+		shift = _mm256_min_epi32(_mm256_max_epi32(shift, zero), _mm256_set1_epi32(WALL_BITS + Gameboard::MAX_X));
+		__m256i row = _mm256_add_epi32(_mm256_add_epi32(y, top), _mm256_set1_epi32(CEILING_ROWS));
+		row = _mm256_min_epi32(_mm256_max_epi32(row, zero), _mm256_set1_epi32(CEILING_ROWS + Gameboard::MAX_Y));
+		__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(row, strides),
+			_mm256_add_epi32(_mm256_set1_epi32(lane), laneOffsets));
+		__m256i hits = zero;
+		for (int i = 0; i < ShapeMask::ROWS; i++) {
+			__m256i boardRow = _mm256_i32gather_epi32(reinterpret_cast<const int*>(board), index, 4);
+			__m256i shapeRow = _mm256_sllv_epi32(_mm256_and_si256(_mm256_srli_epi32(shape, 8 * i), byteMask), shift);
+			hits = _mm256_or_si256(hits, _mm256_and_si256(boardRow, shapeRow));
+			index = _mm256_add_epi32(index, strides);
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(fitsOut + lane), _mm256_and_si256(_mm256_cmpeq_epi32(hits, zero), active));
+	}
+#else
+	for (int block = 0; block < paddedCount; block += LANE_BLOCK) {
+		std::int32_t anyActive = 0;
+		for (int lane = block; lane < block + LANE_BLOCK; lane++) {
+			anyActive |= activeIn[lane];
+		}
+		if (!anyActive) {
+			std::fill(fitsOut + block, fitsOut + block + LANE_BLOCK, 0);
+			continue;
+		}
+		for (int lane = block; lane < block + LANE_BLOCK; lane++) {
+			int piece = pieceIn[lane];
+			int shift = std::min(std::max(xIn[lane] + LANE_MASKS.lefts[piece] + WALL_BITS, 0), WALL_BITS + Gameboard::MAX_X);
+			int row = std::min(std::max(yIn[lane] + LANE_MASKS.tops[piece] + CEILING_ROWS, 0), CEILING_ROWS + Gameboard::MAX_Y);
+			std::uint32_t shape = static_cast<std::uint32_t>(LANE_MASKS.rows[piece]);
+			const WalledRow* stack = &board[row * stride + lane];
+			WalledRow hits = (stack[0] & ((shape & 0xFF) << shift))
+				| (stack[stride] & (((shape >> 8) & 0xFF) << shift))
+				| (stack[2 * stride] & (((shape >> 16) & 0xFF) << shift))
+				| (stack[3 * stride] & (((shape >> 24) & 0xFF) << shift));
+			fitsOut[lane] = -static_cast<std::int32_t>(hits == 0) & activeIn[lane];
+		}
+	}
+#endif
+}
+
+// move every live lane's piece by [xOffset, yOffset] where it fits
+//   set flags[lane] to -1 for the lanes that moved (0 otherwise), return their #
+//   (the moves are tested for every lane at once, then applied with masks - no branches)
+int LockstepSimulation::moveLanes(int xOffset, int yOffset) {
+	for (int lane = 0; lane < paddedCount; lane++) {
+		targetXs[lane] = xs[lane] + xOffset;
+		targetYs[lane] = ys[lane] + yOffset;
+	}
+	fitsLanes(pieces.data(), targetXs.data(), targetYs.data(), alive.data(), fits.data());
+	int count = 0;
+	for (int lane = 0; lane < paddedCount; lane++) {
+		std::int32_t moved = fits[lane] & alive[lane];
+		xs[lane] += moved & xOffset;
+		ys[lane] += moved & yOffset;
+		flags[lane] = moved;
+		count += moved & 1;
+	}
+	return count;
+}
+
+// rotate every live lane's piece by turns clockwise quarter turns (with SRS
+//   wall kicks - the first kicked loc that fits wins), return the # that rotated
+//   (each kick test is one pass of the collision kernel over every lane, and the
+//    passes stop as soon as no lane is still looking for a kick that fits)
+int LockstepSimulation::rotateLanes(int turns) {
+	const int ROTATIONS = TetrominoRotationTable::ROTATIONS;
+	bool anyPending = false;
+	for (int lane = 0; lane < paddedCount; lane++) {
+		int piece = pieces[lane];
+		targetPieces[lane] = piece - piece % ROTATIONS + (piece + turns) % ROTATIONS;
+		pending[lane] = alive[lane];
+		anyPending |= alive[lane] != 0;
+	}
+	for (int test = 0; test < TetrominoKickTable::TESTS && anyPending; test++) {
+		for (int lane = 0; lane < paddedCount; lane++) {
+			int piece = pieces[lane];
+			const BlockOffset& kick = Tetromino::KICK_TABLE.kicks[piece / ROTATIONS][piece % ROTATIONS][turns][test];
+			targetXs[lane] = xs[lane] + kick.x;
+			targetYs[lane] = ys[lane] + kick.y;
+		}
+		fitsLanes(targetPieces.data(), targetXs.data(), targetYs.data(), pending.data(), fits.data());
+		anyPending = false;
+		for (int lane = 0; lane < paddedCount; lane++) {
+			std::int32_t rotated = pending[lane] & fits[lane];
+			pieces[lane] = rotated ? targetPieces[lane] : pieces[lane];
+			xs[lane] = rotated ? targetXs[lane] : xs[lane];
+			ys[lane] = rotated ? targetYs[lane] : ys[lane];
+			pending[lane] &= ~rotated;
+			anyPending |= pending[lane] != 0;
+		}
+	}
+	int count = 0;
+	for (int lane = 0; lane < paddedCount; lane++) {
+		count += alive[lane] & ~pending[lane] & 1;
+	}
+	return count;
+}
+
+// swap every live lane's piece for its held one (where it can still hold),
+//   return the # of lanes that held
+//   (the held piece spawns: a lane where it doesn't fit is game over)
+int LockstepSimulation::holdLanes() {
+	int count = 0;
+	for (int lane = 0; lane < laneCount; lane++) {
+		flags[lane] = 0;
+		if (alive[lane] && queues[lane].canHold()) {
+			TetShape held = queues[lane].hold(static_cast<TetShape>(pieces[lane] / TetrominoRotationTable::ROTATIONS));
+			pieces[lane] = held * TetrominoRotationTable::ROTATIONS;
+			xs[lane] = spawnX;
+			ys[lane] = spawnY;
+			flags[lane] = -1;
+			count++;
+		}
+	}
+	fitsLanes(pieces.data(), xs.data(), ys.data(), flags.data(), fits.data());
+	for (int lane = 0; lane < paddedCount; lane++) {
+		alive[lane] &= ~(flags[lane] & ~fits[lane]);
+	}
+	return count;
+}
+
+// drop every live lane's piece as far as it goes, scoring HARD_DROP_SCORE per row
+//   (every lane still falling moves down a row per pass of the collision kernel)
+void LockstepSimulation::dropLanes() {
+	bool anyFalling = false;
+	for (int lane = 0; lane < paddedCount; lane++) {
+		pending[lane] = alive[lane];
+		anyFalling |= alive[lane] != 0;
+	}
+	while (anyFalling) {
+		for (int lane = 0; lane < paddedCount; lane++) {
+			targetYs[lane] = ys[lane] + 1;
+		}
+		fitsLanes(pieces.data(), xs.data(), targetYs.data(), pending.data(), fits.data());
+		anyFalling = false;
+		for (int lane = 0; lane < paddedCount; lane++) {
+			std::int32_t falling = pending[lane] & fits[lane];
+			ys[lane] += falling & 1;
+			scores[lane] += falling & TetrisSimulation::HARD_DROP_SCORE;
+			pending[lane] = falling;
+			anyFalling |= falling != 0;
+		}
+	}
+}
+
+// lock the piece of every lane with flags[lane] set: merge it into the board,
+//   clear completed rows, score them & spawn the next shape
+//   Completed rows are found for every lane at once (a full walled row is all ones):
+//   only the lanes that completed a row are compacted.
+void LockstepSimulation::lockLanes() {
+	const int stride = paddedCount;
+	for (int lane = 0; lane < laneCount; lane++) {
+		if (!flags[lane]) {
+			continue;
+		}
+		int piece = pieces[lane];
+		int shift = xs[lane] + LANE_MASKS.lefts[piece] + WALL_BITS;
+		int row = ys[lane] + LANE_MASKS.tops[piece] + CEILING_ROWS;
+		std::uint32_t shape = static_cast<std::uint32_t>(LANE_MASKS.rows[piece]);
+		for (int i = 0; i < ShapeMask::ROWS; i++, row++) {
+			WalledRow shapeRow = ((shape >> (8 * i)) & 0xFF) << shift;
+			if (shapeRow != 0 && row >= CEILING_ROWS) {	// (blocks above the board are lost)
+				walledRows[row * stride + lane] |= shapeRow;
+			}
+		}
+		piecesLocked[lane]++;
+	}
+
+	// find the completed rows of every locking lane (pending[lane] bit y = row y is
+	//   completed), a block of LANE_BLOCK lanes at a time (skipping blocks with no lock)
+	std::fill(pending.begin(), pending.end(), 0);
+	for (int block = 0; block < paddedCount; block += LANE_BLOCK) {
+		std::int32_t anyLocking = 0;
+		for (int lane = block; lane < block + LANE_BLOCK; lane++) {
+			anyLocking |= flags[lane];
+		}
+		for (int y = 0; y < Gameboard::MAX_Y && anyLocking; y++) {
+			const WalledRow* row = &walledRows[(CEILING_ROWS + y) * stride];
+			for (int lane = block; lane < block + LANE_BLOCK; lane++) {
+				pending[lane] |= -static_cast<std::int32_t>(row[lane] == SOLID) & (1 << y);
+			}
+		}
+	}
+	for (int lane = 0; lane < laneCount; lane++) {
+		if (pending[lane]) {
+			std::uint32_t fullRows = static_cast<std::uint32_t>(pending[lane]);
+			int count = popCount(fullRows);
+			compactLane(lane, fullRows);
+			scores[lane] += TetrisSimulation::ROW_SCORES[std::min(count, 4)];
+			rowsCleared[lane] += count;
+		}
+	}
+	spawnLanes();
+}
+
+// remove the completed rows (bit y of fullRows) from a lane's board
+//   (one bottom-up pass: each surviving row moves down past the removed rows below it,
+//    then the rows vacated at the top are emptied)
+void LockstepSimulation::compactLane(int lane, std::uint32_t fullRows) {
+	const int stride = paddedCount;
+	int target = Gameboard::MAX_Y - 1;
+	for (int y = Gameboard::MAX_Y - 1; y >= 0; y--) {
+		if (!((fullRows >> y) & 1)) {
+			walledRows[(CEILING_ROWS + target) * stride + lane] = walledRows[(CEILING_ROWS + y) * stride + lane];
+			target--;
+		}
+	}
+	for (; target >= 0; target--) {
+		walledRows[(CEILING_ROWS + target) * stride + lane] = WALLS;
+	}
+}
+
+// put the next piece of each lane with flags[lane] set at the spawn loc, and end
+//   the game in the lanes where it doesn't fit
+void LockstepSimulation::spawnLanes() {
+	for (int lane = 0; lane < laneCount; lane++) {
+		if (flags[lane]) {
+			pieces[lane] = queues[lane].pop() * TetrominoRotationTable::ROTATIONS;
+			xs[lane] = spawnX;
+			ys[lane] = spawnY;
+		}
+	}
+	fitsLanes(pieces.data(), xs.data(), ys.data(), flags.data(), fits.data());
+	for (int lane = 0; lane < paddedCount; lane++) {
+		alive[lane] &= ~(flags[lane] & ~fits[lane]);
+	}
+}
@@ -0,0 +1,166 @@
+// The LockstepSimulation plays many games ("lanes") at once, all driven by the same
+// action schedule - the shape of a reinforcement learning workload, where thousands of
+// boards are stepped together. Every lane follows exactly the rules of TetrisSimulation
+// (the same seed & actions give the same game, block for block), but the state of all
+// lanes is stored as a structure of arrays:
+//  - the boards are walled bitboards (see Gameboard::fits()) laid out row by row, with
+//    one 32 bit word per lane in each row, so row r of lanes 0..7 is one 256 bit load.
+//  - each lane's piece (shape & rotation), loc, score, counters & alive flag sit in a
+//    plain array indexed by lane.
+// Each action runs as a handful of passes over all lanes:
+//  - collision (moves, rotations & their wall kicks, drops, spawns) goes through one
+//    kernel: with AVX2 it tests 8 lanes per iteration (gathering each lane's shape &
+//    board rows, with per lane shifts), otherwise a branch free scalar loop (which the
+//    compiler may vectorize with SSE). Define LOCKSTEP_SCALAR to force the scalar loop.
+//  - locking ORs each locking lane's shape into its board, a dense compare across all
+//    lanes finds completed rows, and only the lanes that completed rows are compacted.
+//  - spawning pops each locking lane's PieceQueue, then tests every new piece at once.
+// There is no clock: tick() is one step of gravity for every lane.
+// Colors aren't stored (only occupancy): a LockstepLane is a read only view of one lane
+// with the same getters as TetrisSimulation.
+//
+//  [expected .cpp size: ~ 450 lines]
+
+#ifndef LOCKSTEPSIMULATION_H
+#define LOCKSTEPSIMULATION_H
+
+#include <cstdint>
+#include <vector>
+#include "TetrisSimulation.h"
+
+#if defined(__AVX2__) && !defined(LOCKSTEP_SCALAR)
+#define LOCKSTEP_AVX2
+#endif
+
+class LockstepSimulation;
+
+// a read only view of one lane of a LockstepSimulation (valid until the simulation
+//   is reset or destroyed)
+class LockstepLane
+{
+public:
+	// return true once a new shape could not be spawned
+	bool isGameOver() const;
+	// getters for the score, the total # of rows cleared & the # of shapes locked
+	int getScore() const;
+	int getRowsCleared() const;
+	int getPiecesLocked() const;
+	// return the falling tetromino (shape, rotation & grid loc)
+	GridTetromino getCurrentShape() const;
+	// return the occupancy bitmask of a given row (as Gameboard::getRowMask())
+	Gameboard::RowMask getRowMask(int rowIndex) const;
+	// return the upcoming shapes & the hold slot
+	const PieceQueue& getPieceQueue() const;
+
+private:
+	LockstepLane(const LockstepSimulation& simulation, int lane);
+
+	const LockstepSimulation* simulation;	// the simulation viewed
+	int lane;								// the lane viewed
+
+	friend class LockstepSimulation;
+};
+
+class LockstepSimulation
+{
+public:
+	static const int LANE_BLOCK = 8;	// lanes are stored in blocks of 8 (one AVX2 vector)
+
+	// constructor, one lane per seed (each lane plays the game TetrisSimulation(seed) would)
+	LockstepSimulation(const std::vector<std::uint64_t>& seeds = std::vector<std::uint64_t>());
+
+	// start a new game in every lane, one lane per seed
+	void reset(const std::vector<std::uint64_t>& seeds);
+
+	// return the # of lanes
+	int getLaneCount() const;
+	// return the # of lanes still playing (not game over)
+	int getLiveLaneCount() const;
+	// return a view of one lane
+	LockstepLane getLane(int lane) const;
+
+	// apply a player action to the current shape of every live lane
+	//   (as TetrisSimulation::applyAction() does for one game)
+	//   return the # of lanes it did anything in
+	int applyAction(InputAction action);
+
+	// one step of gravity for every live lane: move the current shape down a row,
+	//   or lock it if it can't move (as TetrisSimulation::tick())
+	void tick();
+
+	// return the name of the collision kernel compiled in ("avx2" or "scalar")
+	static const char* getKernelName();
+
+private:
+	// the walled bitboard rows of each lane: CEILING_ROWS open rows, one row per board
+	//   row & FLOOR_ROWS solid rows (see Gameboard::fits()), 32 bits are enough here
+	typedef std::uint32_t WalledRow;
+	static const int CEILING_ROWS = Gameboard::CEILING_ROWS;
+	static const int FLOOR_ROWS = Gameboard::FLOOR_ROWS;
+	static const int WALL_BITS = Gameboard::WALL_BITS;
+	static const int STACK_ROWS = CEILING_ROWS + Gameboard::MAX_Y + FLOOR_ROWS;
+	static const WalledRow WALLS = static_cast<WalledRow>(~(WalledRow(Gameboard::FULL_ROW) << WALL_BITS));
+	static const WalledRow SOLID = ~WalledRow(0);
+	static_assert(Gameboard::MAX_X + 2 * WALL_BITS <= 32, "a walled row must fit in 32 bits");
+
+	// for every lane with activeIn[lane] set, fitsOut[lane] = -1 if the piece pieceIn[lane]
+	//   (shape * 4 + rotation) fits with its origin at [xIn[lane], yIn[lane]] on that lane's
+	//   board, 0 if not (fitsOut is 0 for the inactive lanes)
+	//   (the collision kernel, see Gameboard::fits() - blocks of LANE_BLOCK lanes with no
+	//    active lane are skipped, the others are tested whole)
+	void fitsLanes(const std::int32_t* pieceIn, const std::int32_t* xIn, const std::int32_t* yIn,
+		const std::int32_t* activeIn, std::int32_t* fitsOut) const;
+
+	// move every live lane's piece by [xOffset, yOffset] where it fits
+	//   set flags[lane] to -1 for the lanes that moved (0 otherwise), return their #
+	int moveLanes(int xOffset, int yOffset);
+	// rotate every live lane's piece by turns clockwise quarter turns (with SRS
+	//   wall kicks - the first kicked loc that fits wins), return the # that rotated
+	int rotateLanes(int turns);
+	// swap every live lane's piece for its held one (where it can still hold),
+	//   return the # of lanes that held
+	int holdLanes();
+	// drop every live lane's piece as far as it goes, scoring HARD_DROP_SCORE per row
+	void dropLanes();
+	// lock the piece of every lane with flags[lane] set: merge it into the board,
+	//   clear completed rows, score them & spawn the next shape
+	void lockLanes();
+	// remove the completed rows (bit y of fullRows) from a lane's board
+	void compactLane(int lane, std::uint32_t fullRows);
+	// put the next piece of each lane with flags[lane] set at the spawn loc, and end
+	//   the game in the lanes where it doesn't fit
+	void spawnLanes();
+
+	// MEMBER VARIABLES
+
+	int laneCount = 0;		// # of lanes played
+	int paddedCount = 0;	// laneCount rounded up to a LANE_BLOCK (the extra lanes are never alive)
+	int spawnX = 0;			// the gameboard spawn loc
+	int spawnY = 0;
+
+	// the boards: walledRows[row * paddedCount + lane] (row 0 is the top ceiling row)
+	std::vector<WalledRow> walledRows;
+	// per lane state
+	std::vector<std::int32_t> pieces;		// current shape * 4 + rotation
+	std::vector<std::int32_t> xs;			// current shape's grid loc
+	std::vector<std::int32_t> ys;
+	std::vector<std::int32_t> alive;		// -1 while playing, 0 once game over
+	std::vector<std::int32_t> scores;
+	std::vector<std::int32_t> rowsCleared;
+	std::vector<std::int32_t> piecesLocked;
+	std::vector<PieceQueue> queues;
+	// scratch lanes for the kernels (kept, so stepping never allocates)
+	std::vector<std::int32_t> targetPieces;
+	std::vector<std::int32_t> targetXs;
+	std::vector<std::int32_t> targetYs;
+	std::vector<std::int32_t> fits;
+	std::vector<std::int32_t> flags;		// moved / locking / spawning, per lane
+	std::vector<std::int32_t> pending;
+
+	friend class LockstepLane;
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* LOCKSTEPSIMULATION_H */
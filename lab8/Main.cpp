@@ -4,12 +4,17 @@
 #include <iostream>
 #include "TetrisGame.h"
 #include "TestSuite.h"
+#include "BenchmarkSuite.h"
 
 
 int main()
 {
 	// run some sanity tests on our classes to ensure they're working as expected.
+	//   (the tests need AllocationCounter.cpp, which replaces the global operator new:
+	//    it isn't part of the game - run them with the tetris_tests build instead)
 	//assert(TestSuite::runTestSuite());
+	// time the hot gameboard operations (build in Release for meaningful numbers).
+	//BenchmarkSuite::runBenchmarks();
 
 	sf::Sprite blockSprite;			// the tetromino block sprite
 	sf::Texture blockTexture;		// the tetromino block texture
@@ -23,23 +28,22 @@ int main()
 	blockTexture.loadFromFile("images/tiles.png");			// load the tetris block sprite
 	blockSprite.setTexture(blockTexture);
 
-	srand((unsigned int)time(0));	// seed our randomizer
-
 	// create the game window
 	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");
 
 	// set up a tetris game
-	TetrisGame game(&window, &blockSprite, Point(54, 125), Point(490, 210));
+	//   (seeded from the clock: pass a fixed seed to replay a piece sequence)
+	TetrisGame game(&window, &blockSprite, Point(54, 125), Point(490, 210), static_cast<std::uint64_t>(time(0)));
 
 
-	sf::Clock clock;	// set up a clock so we can determine seconds per game loop
+	sf::Clock clock;	// set up a clock so we can determine the time per game loop
 
 	// the main game loop
 	while (window.isOpen())
 	{
-		// how long since the last loop (fraction of a second)
-		float gameLoopSeconds = clock.getElapsedTime().asSeconds();
-		clock.restart();
+		// how long since the last loop (in whole microseconds - restart() returns the
+		//   time up to the restart itself, so no time is lost between loops)
+		std::int64_t gameLoopMicros = clock.restart().asMicroseconds();
 
 		// handle any window or keyboard events that have occured since the last game loop
 		sf::Event event;
@@ -55,7 +59,7 @@ int main()
 			}
 		}
 
-		game.processGameLoop(gameLoopSeconds);	// handle tetris game logic in here.
+		game.processGameLoop(gameLoopMicros);	// handle tetris game logic in here.
 
 
 		window.clear(sf::Color::White);		// clear the entire window
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include "MoveGenerator.h"
+
+// the mask of every valid column of a state row
+static const MoveGenerator::StateRow ALL_COLUMNS = (MoveGenerator::StateRow(1) << MoveGenerator::STATE_COLUMNS) - 1;
+
+// the action that turns a shape by turns clockwise quarter turns
+static InputAction getRotateAction(int turns) {
+	return (turns == 1) ? ACTION_ROTATE_CW : (turns == 2) ? ACTION_ROTATE_180 : ACTION_ROTATE_CCW;
+}
+
+// constructor
+MoveGenerator::MoveGenerator() {
+	placements.reserve(64);
+	paths.reserve(64 * 16);
+	reversePath.reserve(64);
+}
+
+// find every placement shape (at its current rotation & grid loc) can reach on board
+//   return the # of placements (0 if the shape doesn't fit where it is)
+//   The placements are in order of path length (shortest first).
+int MoveGenerator::generate(const Gameboard& board, const GridTetromino& shape) {
+	Gameboard::RowMask rows[Gameboard::MAX_Y];
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		rows[y] = board.getRowMask(y);
+	}
+	return generate(rows, shape);
+}
+
+// the same, on the board with row masks rows[0..MAX_Y - 1] (eg: a search node's board)
+//   Each pass of the loop hard drops the current layer (keeping the new landings),
+//   then expands it by one input: moves are shifts, soft drops move a row down, and
+//   each rotation tests its kicks in order on the states that haven't fit yet.
+//   (only the state rows the layer spans are visited)
+int MoveGenerator::generate(const Gameboard::RowMask* rows, const GridTetromino& shape) {
+	placements.clear();
+	paths.clear();
+	buildFitRows(rows, shape);
+	std::memset(reached, 0, sizeof(reached));
+	std::memset(landed, 0, sizeof(landed));
+	std::memset(next, 0, sizeof(next));
+	nextTop = STATE_ROWS;
+	nextBottom = -1;
+
+	int rotation = shape.getRotation();
+	int row = shape.getGridLoc().getY() + Y_OFFSET;
+	int column = shape.getGridLoc().getX() + X_OFFSET;
+	if (row < 0 || row >= STATE_ROWS || column < 0 || column >= STATE_COLUMNS || !fitsAt(rotation, row, column)) {
+		return 0;
+	}
+	reach(rotation, row, StateRow(1) << column, VIA_START);
+
+	StateRow layer[ROTATIONS][STATE_ROWS];
+	while (nextTop <= nextBottom) {
+		int top = nextTop;
+		int bottom = nextBottom;
+		for (int r = 0; r < ROTATIONS; r++) {
+			for (int y = top; y <= bottom; y++) {
+				layer[r][y] = next[r][y];
+				next[r][y] = 0;
+			}
+		}
+		nextTop = STATE_ROWS;
+		nextBottom = -1;
+		landLayer(layer, top, bottom);
+
+		for (int from = 0; from < ROTATIONS; from++) {
+			for (int y = top; y <= bottom; y++) {
+				StateRow states = layer[from][y];
+				if (states == 0) {
+					continue;
+				}
+				reach(from, y, (states >> 1) & fitRows[from][y], VIA_LEFT);
+				reach(from, y, (states << 1) & fitRows[from][y], VIA_RIGHT);
+				reach(from, y + 1, states & getFitRow(from, y + 1), VIA_DOWN);
+				for (int turns = 1; turns < ROTATIONS; turns++) {
+					int to = (from + turns) % ROTATIONS;
+					StateRow untried = states;	// the states no kick has fitted yet
+					for (int test = 0; test < TetrominoKickTable::TESTS && untried != 0; test++) {
+						const BlockOffset& kick = Tetromino::KICK_TABLE.kicks[shape.getShape()][from][turns][test];
+						StateRow moved = shiftColumns(untried, kick.x) & getFitRow(to, y + kick.y);
+						reach(to, y + kick.y, moved, VIA_ROTATE + (turns - 1) * TetrominoKickTable::TESTS + test);
+						untried &= ~shiftColumns(moved, -kick.x);
+					}
+				}
+			}
+		}
+	}
+	return static_cast<int>(placements.size());
+}
+
+// return the # of placements found by the last generate()
+int MoveGenerator::getPlacementCount() const {
+	return static_cast<int>(placements.size());
+}
+
+// return placement # index (by reference - no copy is made)
+const MoveGenerator::Placement& MoveGenerator::getPlacement(int index) const {
+	return placements[index];
+}
+
+// return the input path of placement # index (getPlacement(index).pathLength actions)
+const InputAction* MoveGenerator::getPath(int index) const {
+	return paths.data() + placements[index].pathStart;
+}
+
+// build the fit rows of every rotation of shape on the board with row masks rows
+//   (fitRows[rotation][y + Y_OFFSET] bit x + X_OFFSET = the shape fits at [x, y])
+//   A block in column j of a mask row collides at x where the walled board row
+//   has bit x + left + j + WALL_BITS set: so the blocked states of a mask row are
+//   the OR of the walled row shifted right once per block - 4 shifts per state row.
+void MoveGenerator::buildFitRows(const Gameboard::RowMask* rows, const Tetromino& shape) {
+	typedef Gameboard::WalledRow WalledRow;
+	this->shape = shape.getShape();
+	for (int rotation = 0; rotation < ROTATIONS; rotation++) {
+		masks[rotation] = shape.getShapeMask(rotation);
+	}
+	for (int rotation = 0; rotation < ROTATIONS; rotation++) {
+		const ShapeMask& mask = masks[rotation];
+		for (int row = 0; row < STATE_ROWS; row++) {
+			WalledRow blocked = 0;
+			for (int i = 0; i < ShapeMask::ROWS; i++) {
+				if (mask.rows[i] == 0) {
+					continue;
+				}
+				int boardRow = row - Y_OFFSET + mask.top + i;
+				WalledRow walled = (boardRow < 0) ? Gameboard::WALLS
+					: (boardRow >= Gameboard::MAX_Y) ? ~WalledRow(0)
+					: (WalledRow(rows[boardRow]) << Gameboard::WALL_BITS) | Gameboard::WALLS;
+				for (int j = 0; j < ShapeMask::COLUMNS; j++) {
+					if ((mask.rows[i] >> j) & 1) {
+						int shift = mask.left + j + Gameboard::WALL_BITS - X_OFFSET;
+						assert(shift >= 0);
+						blocked |= walled >> shift;
+					}
+				}
+			}
+			fitRows[rotation][row] = static_cast<StateRow>(~blocked) & ALL_COLUMNS;
+		}
+	}
+}
+
+// return true if the shape fits in a rotation at a state row & column
+bool MoveGenerator::fitsAt(int rotation, int row, int column) const {
+	return (getFitRow(rotation, row) >> column) & 1;
+}
+
+// return the fit row of a rotation at a state row (rows above the state rows are
+//   open, like the top one: rows below them are the floor, where nothing fits)
+MoveGenerator::StateRow MoveGenerator::getFitRow(int rotation, int row) const {
+	return (row < 0) ? fitRows[rotation][0] : (row < STATE_ROWS) ? fitRows[rotation][row] : 0;
+}
+
+// add the states in add (for rotation at state row), first reached by how, to the next layer
+//   (states above the state rows, or already reached, are dropped)
+void MoveGenerator::reach(int rotation, int row, StateRow add, int how) {
+	if (row < 0 || row >= STATE_ROWS) {
+		return;
+	}
+	add &= ~reached[rotation][row];
+	if (add == 0) {
+		return;
+	}
+	reached[rotation][row] |= add;
+	next[rotation][row] |= add;
+	nextTop = std::min(nextTop, row);
+	nextBottom = std::max(nextBottom, row);
+	while (add != 0) {
+		via[rotation][row][countTrailingZeros(add)] = static_cast<std::uint8_t>(how);
+		add &= add - 1;
+	}
+}
+
+// hard drop every state of the layer (in state rows top..bottom) & keep each new
+//   landing (with its path)
+//   A row of states falls together: at each row, the states that can't go any lower
+//   (don't fit in the row below) have landed, the rest fall on.
+//   A landing fills the same cells as its twins - the same mask rows in another
+//   rotation (eg: S, Z & I turned 180 degrees), moved by the difference in their
+//   offsets - so those are marked landed too.
+void MoveGenerator::landLayer(const StateRow (&layer)[ROTATIONS][STATE_ROWS], int top, int bottom) {
+	for (int rotation = 0; rotation < ROTATIONS; rotation++) {
+		const ShapeMask& mask = masks[rotation];
+		for (int row = top; row <= bottom; row++) {
+			StateRow falling = layer[rotation][row];
+			for (int y = row; falling != 0; y++) {
+				StateRow stopped = falling & ~getFitRow(rotation, y + 1);
+				falling &= ~stopped;
+				for (StateRow landings = stopped & ~landed[rotation][y]; landings != 0; landings &= landings - 1) {
+					int column = countTrailingZeros(landings);
+					for (int twin = 0; twin < ROTATIONS; twin++) {
+						const ShapeMask& twinMask = masks[twin];
+						int twinRow = y + mask.top - twinMask.top;
+						int twinColumn = column + mask.left - twinMask.left;
+						if (std::equal(mask.rows, mask.rows + ShapeMask::ROWS, twinMask.rows)
+							&& twinRow >= 0 && twinRow < STATE_ROWS && twinColumn >= 0 && twinColumn < STATE_COLUMNS) {
+							landed[twin][twinRow] |= StateRow(1) << twinColumn;
+						}
+					}
+					Placement placement;
+					placement.piece.shape = static_cast<std::uint8_t>(shape);
+					placement.piece.rotation = static_cast<std::uint8_t>(rotation);
+					placement.piece.x = static_cast<std::int8_t>(column - X_OFFSET);
+					placement.piece.y = static_cast<std::int8_t>(y - Y_OFFSET);
+					placement.pathStart = static_cast<int>(paths.size());
+					appendPath(rotation, row, column);
+					placement.pathLength = static_cast<int>(paths.size()) - placement.pathStart;
+					placements.push_back(placement);
+				}
+			}
+		}
+	}
+}
+
+// append the path to a state (rotation, state row, column), then a hard drop
+//   (traced back from the state, one recorded input at a time, to the start)
+void MoveGenerator::appendPath(int rotation, int row, int column) {
+	reversePath.clear();
+	for (int how = via[rotation][row][column]; how != VIA_START; how = via[rotation][row][column]) {
+		if (how == VIA_LEFT) {
+			reversePath.push_back(ACTION_LEFT);
+			column++;
+		}
+		else if (how == VIA_RIGHT) {
+			reversePath.push_back(ACTION_RIGHT);
+			column--;
+		}
+		else if (how == VIA_DOWN) {
+			reversePath.push_back(ACTION_SOFT_DROP);
+			row--;
+		}
+		else {
+			int turns = (how - VIA_ROTATE) / TetrominoKickTable::TESTS + 1;
+			int test = (how - VIA_ROTATE) % TetrominoKickTable::TESTS;
+			rotation = (rotation + ROTATIONS - turns) % ROTATIONS;
+			const BlockOffset& kick = Tetromino::KICK_TABLE.kicks[shape][rotation][turns][test];
+			reversePath.push_back(getRotateAction(turns));
+			column -= kick.x;
+			row -= kick.y;
+		}
+	}
+	paths.insert(paths.end(), reversePath.rbegin(), reversePath.rend());
+	paths.push_back(ACTION_HARD_DROP);
+}
+
+// return a row of states moved by dx columns (the states moved off it are lost)
+MoveGenerator::StateRow MoveGenerator::shiftColumns(StateRow states, int dx) {
+	return ((dx >= 0) ? (states << dx) : (states >> -dx)) & ALL_COLUMNS;
+}
@@ -0,0 +1,121 @@
+// The MoveGenerator finds every placement a tetromino can reach from where it is (its
+// spawn loc, for a new piece) - including tucks under overhangs and kicked spins - and
+// the shortest input path to each one, without playing out any input sequences.
+// Functionality:
+//  - The states of a shape are (rotation, x, y). For each rotation & row, a bitmask of
+//    the x positions where the shape fits is built from the board's row masks with a
+//    few shifts & ORs (the "fit rows").
+//  - A breadth first flood fill runs over those bitmasks, a whole layer (every state
+//    one input further away) at a time: a move left/right is a shift of a row, a soft
+//    drop moves a row down, and a rotation tries the SRS kicks in order on every state
+//    of the layer at once (the first kick that fits wins, as in TetrisSimulation).
+//    Each state records the input that first reached it, which is on a shortest path.
+//  - Every reached state is hard dropped; each distinct landing (by the cells it fills:
+//    eg: the O looks the same in all 4 rotations) is kept once, with its shortest path.
+//    A path ends with ACTION_HARD_DROP (and uses no ticks: gravity is not modelled).
+// Shapes kicked more than Y_OFFSET rows above the board are not followed.
+//
+//  [expected .cpp size: ~ 250 lines]
+
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "TetrisSimulation.h"
+
+class MoveGenerator
+{
+public:
+	// CONSTANTS
+	static const int ROTATIONS = TetrominoRotationTable::ROTATIONS;
+	static const int X_OFFSET = 2;	// bit x + X_OFFSET of a state row is the state at x
+	static const int Y_OFFSET = 4;	// state row y + Y_OFFSET holds the states at y
+	static const int STATE_COLUMNS = Gameboard::MAX_X + 2 * X_OFFSET;
+	static const int STATE_ROWS = Gameboard::MAX_Y + Y_OFFSET;
+
+	// one row of states (bit x + X_OFFSET = the state at x)
+	typedef std::uint32_t StateRow;
+	static_assert(STATE_COLUMNS <= 32, "a row of states must fit in 32 bits");
+
+	// a distinct landing & the shortest input path to it
+	struct Placement
+	{
+		PackedPiece piece;	// the shape, rotation & loc it locks at
+		int pathStart;		// its path: pathLength actions from pathStart (see getPath())
+		int pathLength;
+	};
+
+	// constructor
+	MoveGenerator();
+
+	// find every placement shape (at its current rotation & grid loc) can reach on board
+	//   return the # of placements (0 if the shape doesn't fit where it is)
+	//   The placements are in order of path length (shortest first).
+	int generate(const Gameboard& board, const GridTetromino& shape);
+	// the same, on the board with row masks rows[0..MAX_Y - 1] (eg: a search node's board)
+	int generate(const Gameboard::RowMask* rows, const GridTetromino& shape);
+
+	// return the # of placements found by the last generate()
+	int getPlacementCount() const;
+	// return placement # index (by reference - no copy is made)
+	const Placement& getPlacement(int index) const;
+	// return the input path of placement # index (getPlacement(index).pathLength actions)
+	const InputAction* getPath(int index) const;
+
+private:
+	// how a state was first reached (for the path back to the start)
+	enum Via {
+		VIA_START,
+		VIA_LEFT,
+		VIA_RIGHT,
+		VIA_DOWN,
+		VIA_ROTATE	// + (turns - 1) * TESTS + kick test #
+	};
+
+	// build the fit rows of every rotation of shape on the board with row masks rows
+	//   (fitRows[rotation][y + Y_OFFSET] bit x + X_OFFSET = the shape fits at [x, y])
+	void buildFitRows(const Gameboard::RowMask* rows, const Tetromino& shape);
+
+	// return true if the shape fits in a rotation at a state row & column
+	bool fitsAt(int rotation, int row, int column) const;
+	// return the fit row of a rotation at a state row (rows above the state rows are
+	//   open, like the top one: rows below them are the floor, where nothing fits)
+	StateRow getFitRow(int rotation, int row) const;
+
+	// add the states in add (for rotation at state row), first reached by how, to the next layer
+	void reach(int rotation, int row, StateRow add, int how);
+
+	// hard drop every state of the layer (in state rows top..bottom) & keep each new
+	//   landing (with its path)
+	void landLayer(const StateRow (&layer)[ROTATIONS][STATE_ROWS], int top, int bottom);
+
+	// append the path to a state (rotation, state row, column), then a hard drop
+	void appendPath(int rotation, int row, int column);
+
+	// return a row of states moved by dx columns (the states moved off it are lost)
+	static StateRow shiftColumns(StateRow states, int dx);
+
+	// MEMBER VARIABLES
+	TetShape shape = SHAPE_S;						// the shape being placed
+	ShapeMask masks[ROTATIONS];						// its ShapeMask in each rotation
+	StateRow fitRows[ROTATIONS][STATE_ROWS];		// where it fits
+	StateRow reached[ROTATIONS][STATE_ROWS];		// the states reached so far
+	StateRow landed[ROTATIONS][STATE_ROWS];			// the landings kept so far (and their twins)
+	StateRow next[ROTATIONS][STATE_ROWS];			// the layer being built
+	int nextTop = STATE_ROWS;						// the state rows it spans (none: top > bottom)
+	int nextBottom = -1;
+	std::uint8_t via[ROTATIONS][STATE_ROWS][STATE_COLUMNS];	// how each reached state was reached
+
+	std::vector<Placement> placements;	// the placements found
+	std::vector<InputAction> paths;		// all of their paths, back to back
+	std::vector<InputAction> reversePath;	// scratch (a path is traced back from its end)
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* MOVEGENERATOR_H */
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include "Perft.h"
+
+const std::uint64_t Perft::REFERENCE_SEED;
+const int Perft::REFERENCE_GARBAGE_ROWS;
+const int Perft::REFERENCE_DEPTH;
+
+// the counts of the reference position (seed REFERENCE_SEED, REFERENCE_GARBAGE_ROWS
+//   garbage rows) for depths 1..REFERENCE_DEPTH. Any change to the rotation, kick,
+//   collision, locking or row clearing rules changes them: only update them along with
+//   such a change, after checking the new counts are right.
+const std::uint64_t Perft::REFERENCE_PATHS[REFERENCE_DEPTH] = { 17, 591, 10639, 101070 };
+const std::uint64_t Perft::REFERENCE_DISTINCT[REFERENCE_DEPTH] = { 17, 591, 10639, 100924 };
+
+// the content the boards are filled with (only occupancy is compared)
+static const int BLOCK_CONTENT = static_cast<int>(TetColor::RED);
+
+// constructor, the position of seed: garbageRows garbage rows & its piece sequence
+//   A garbage row is full but for one hole, in a random column (from the seed).
+Perft::Perft(std::uint64_t seed, int garbageRows) : pieces(seed) {
+	assert(garbageRows >= 0 && garbageRows < Gameboard::MAX_Y);
+	root.empty();
+	for (int y = Gameboard::MAX_Y - garbageRows; y < Gameboard::MAX_Y; y++) {
+		int hole = static_cast<int>(PieceGenerator::random(seed, y) % Gameboard::MAX_X);
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (x != hole) {
+				root.setContent(x, y, BLOCK_CONTENT);
+			}
+		}
+	}
+}
+
+// count the paths & distinct boards of depths 1..depth, on threadCount threads
+//   (0 = one per hardware thread)
+//   One thread searches ply by ply over every board. More threads split the root:
+//   the boards after the first piece are dealt out one at a time, each thread searches
+//   the subtree of each board it takes into its own levels, and the levels are merged
+//   (summing the paths to each board) once all of the threads are done.
+PerftResult Perft::run(int depth, int threadCount) const {
+	typedef std::chrono::steady_clock Clock;
+	assert(depth >= 1);
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	threadCount = std::max(threadCount, 1);
+
+	Clock::time_point start = Clock::now();
+	BoardCounts rootBoards;
+	rootBoards[getKey(root)] = 1;
+	std::vector<BoardCounts> levels(depth);	// levels[d - 1]: the boards after d pieces
+	std::vector<Searcher> searchers(threadCount);
+	if (threadCount == 1 || depth == 1) {
+		search(rootBoards, 0, depth, levels, searchers[0]);
+	}
+	else {
+		expand(rootBoards, 0, levels[0], searchers[0]);
+		std::vector<BoardCounts::value_type> roots(levels[0].begin(), levels[0].end());
+		std::atomic<std::size_t> nextRoot(0);
+		std::vector<std::vector<BoardCounts>> threadLevels(threadCount, std::vector<BoardCounts>(depth));
+		auto work = [&](int thread) {
+			for (std::size_t i = nextRoot++; i < roots.size(); i = nextRoot++) {
+				BoardCounts subtree;
+				subtree.insert(roots[i]);
+				search(subtree, 1, depth, threadLevels[thread], searchers[thread]);
+			}
+		};
+		std::vector<std::thread> threads;
+		for (int i = 1; i < threadCount; i++) {
+			threads.emplace_back(work, i);
+		}
+		work(0);	// (this thread is thread 0)
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		for (int thread = 0; thread < threadCount; thread++) {
+			for (int d = 1; d < depth; d++) {
+				for (const BoardCounts::value_type& board : threadLevels[thread][d]) {
+					levels[d][board.first] += board.second;
+				}
+			}
+		}
+	}
+
+	PerftResult result;
+	result.threads = threadCount;
+	for (const BoardCounts& level : levels) {
+		std::uint64_t paths = 0;
+		for (const BoardCounts::value_type& board : level) {
+			paths += board.second;
+		}
+		result.paths.push_back(paths);
+		result.distinct.push_back(level.size());
+	}
+	for (const Searcher& searcher : searchers) {
+		result.expanded += searcher.expanded;
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return result;
+}
+
+// return true if result matches the reference counts (for as many depths as both have)
+//   (result must come from the reference position)
+bool Perft::matchesReference(const PerftResult& result) {
+	int depths = std::min(static_cast<int>(result.paths.size()), REFERENCE_DEPTH);
+	for (int d = 0; d < depths; d++) {
+		if (result.paths[d] != REFERENCE_PATHS[d] || result.distinct[d] != REFERENCE_DISTINCT[d]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// print a table of result's counts per depth, and its speed (boards expanded per second)
+void Perft::printReport(std::ostream& out, const PerftResult& result) {
+	out << std::setw(6) << "depth" << std::setw(16) << "paths" << std::setw(14) << "distinct" << "\n";
+	for (std::size_t d = 0; d < result.paths.size(); d++) {
+		out << std::setw(6) << d + 1 << std::setw(16) << result.paths[d] << std::setw(14) << result.distinct[d] << "\n";
+	}
+	double seconds = std::max(result.seconds, 1e-9);
+	out << "threads: " << result.threads << "  boards expanded: " << result.expanded
+		<< "  seconds: " << std::fixed << std::setprecision(3) << result.seconds
+		<< "  boards/sec: " << std::setprecision(0) << result.expanded / seconds << "\n";
+	out.unsetf(std::ios_base::floatfield);
+	out << std::setprecision(6);
+}
+
+// return the starting board (by reference - no copy is made)
+const Gameboard& Perft::getRootBoard() const {
+	return root;
+}
+
+// return the shape placed at ply # ply (0 = the first piece)
+TetShape Perft::getShape(int ply) const {
+	return pieces.getShapeAt(static_cast<std::uint64_t>(ply));
+}
+
+// hash a board key (see Gameboard::getOccupancyHash())
+std::size_t Perft::BoardKeyHash::operator()(const BoardKey& key) const {
+	return static_cast<std::size_t>(Gameboard::getOccupancyHash(key.data()));
+}
+
+// add the children of every board in boards (the boards after ply pieces) to
+//   children: each board with piece # ply placed in each way (& rows cleared)
+//   Each placement is locked into the board itself, then taken back out (or the board
+//   is rebuilt from its key, if it cleared rows). A child reached from n paths adds n
+//   paths to it. A placement with a block above the board locks out (it has no child),
+//   as does a board the piece can't spawn on.
+void Perft::expand(const BoardCounts& boards, int ply, BoardCounts& children, Searcher& searcher) const {
+	GridTetromino shape;
+	shape.setShape(getShape(ply));
+	std::array<Point, GridTetromino::BLOCK_COUNT> cells;
+	for (const BoardCounts::value_type& board : boards) {
+		setBoard(board.first, searcher.board);
+		shape.setRotation(0);
+		shape.setGridLoc(searcher.board.getSpawnLoc());
+		int count = searcher.generator.generate(searcher.board, shape);
+		searcher.expanded++;
+		for (int i = 0; i < count; i++) {
+			GridTetromino placed;
+			placed.unpack(searcher.generator.getPlacement(i).piece);
+			placed.getBlockLocsMappedToGrid(cells);
+			bool lockedOut = false;
+			for (const Point& cell : cells) {
+				lockedOut = lockedOut || cell.getY() < 0;
+			}
+			if (lockedOut) {
+				continue;
+			}
+			for (const Point& cell : cells) {
+				searcher.board.setContent(cell, BLOCK_CONTENT);
+			}
+			bool cleared = searcher.board.removeCompletedRows() > 0;
+			children[getKey(searcher.board)] += board.second;
+			if (cleared) {
+				setBoard(board.first, searcher.board);
+			}
+			else {
+				for (const Point& cell : cells) {
+					searcher.board.setContent(cell, Gameboard::EMPTY_BLOCK);
+				}
+			}
+		}
+	}
+}
+
+// search the subtree of the boards after ply pieces down to depth, adding the
+//   distinct boards of each ply below it into levels[ply + 1 ..]
+//   (ply by ply: each ply's boards are deduplicated before the next ply expands them)
+void Perft::search(const BoardCounts& boards, int ply, int depth, std::vector<BoardCounts>& levels, Searcher& searcher) const {
+	BoardCounts frontier;
+	BoardCounts children;
+	const BoardCounts* parents = &boards;
+	for (int p = ply; p < depth && !parents->empty(); p++) {
+		children.clear();
+		expand(*parents, p, children, searcher);
+		for (const BoardCounts::value_type& board : children) {
+			levels[p][board.first] += board.second;
+		}
+		frontier.swap(children);
+		parents = &frontier;
+	}
+}
+
+// return the key of a board (its row masks)
+Perft::BoardKey Perft::getKey(const Gameboard& board) {
+	BoardKey key;
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		key[y] = board.getRowMask(y);
+	}
+	return key;
+}
+
+// set a board to the occupancy of a key
+void Perft::setBoard(const BoardKey& key, Gameboard& board) {
+	board.empty();
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (Gameboard::RowMask row = key[y]; row != 0; row &= row - 1) {
+			board.setContent(countTrailingZeros(row), y, BLOCK_CONTENT);
+		}
+	}
+}
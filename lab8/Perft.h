@@ -0,0 +1,112 @@
+// Perft ("performance test", after the chess engine tool) counts every way to place the
+// next N pieces from a starting position, to validate and benchmark the move generator,
+// collision, locking & row clearing all at once.
+// Functionality:
+//  - The position: a board seeded with garbage rows (full but for one hole each) and the
+//    piece sequence of a PieceGenerator, both from one seed. No hold.
+//  - Depth d counts the placement sequences of d pieces (paths) and the distinct boards
+//    they reach (by occupancy). Each ply places the piece with every placement the
+//    MoveGenerator finds, locks it & clears rows on a Gameboard; the boards of a ply are
+//    deduplicated (with the # of paths to each) before the next ply expands them.
+//    A placement with blocks above the board locks out (it is not counted), and a
+//    board whose next piece can't spawn has no children.
+//  - Multithreaded mode splits the root: the distinct boards after the first piece are
+//    handed out to the threads one at a time, each thread searches their subtrees into
+//    boards of its own, and those are merged once every thread is done. The counts are
+//    the same for any # of threads.
+//  - The counts of a reference position are checked in (REFERENCE_PATHS/DISTINCT): any
+//    change to the rules that alters them is caught by the tests (& tetris_perft --verify),
+//    and the report's boards/sec shows any change in speed.
+//
+//  [expected .cpp size: ~ 250 lines]
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "Gameboard.h"
+#include "MoveGenerator.h"
+#include "PieceGenerator.h"
+
+// the counts of one perft run, for each depth d (1..N) at index d - 1
+struct PerftResult
+{
+	std::vector<std::uint64_t> paths;		// the # of placement sequences of d pieces
+	std::vector<std::uint64_t> distinct;	// the # of distinct boards they reach
+	std::uint64_t expanded = 0;				// the # of boards expanded (move generator runs)
+	int threads = 1;						// the # of threads searched with
+	double seconds = 0.0;					// wall clock time
+};
+
+class Perft
+{
+public:
+	// the reference position & its checked in counts (see the .cpp)
+	static const std::uint64_t REFERENCE_SEED = 1;
+	static const int REFERENCE_GARBAGE_ROWS = 4;
+	static const int REFERENCE_DEPTH = 4;
+	static const std::uint64_t REFERENCE_PATHS[REFERENCE_DEPTH];
+	static const std::uint64_t REFERENCE_DISTINCT[REFERENCE_DEPTH];
+
+	// constructor, the position of seed: garbageRows garbage rows & its piece sequence
+	Perft(std::uint64_t seed = REFERENCE_SEED, int garbageRows = REFERENCE_GARBAGE_ROWS);
+
+	// count the paths & distinct boards of depths 1..depth, on threadCount threads
+	PerftResult run(int depth, int threadCount = 1) const;
+
+	// return true if result matches the reference counts (for as many depths as both have)
+	//   (result must come from the reference position)
+	static bool matchesReference(const PerftResult& result);
+
+	// print a table of result's counts per depth, and its speed (boards expanded per second)
+	static void printReport(std::ostream& out, const PerftResult& result);
+
+	// return the starting board (by reference - no copy is made)
+	const Gameboard& getRootBoard() const;
+	// return the shape placed at ply # ply (0 = the first piece)
+	TetShape getShape(int ply) const;
+
+private:
+	// a board's occupancy (its row masks): the key boards are deduplicated by
+	typedef std::array<Gameboard::RowMask, Gameboard::MAX_Y> BoardKey;
+	struct BoardKeyHash
+	{
+		std::size_t operator()(const BoardKey& key) const;
+	};
+	// the distinct boards of a ply, each with the # of paths that reach it
+	typedef std::unordered_map<BoardKey, std::uint64_t, BoardKeyHash> BoardCounts;
+
+	// the scratch space of one searching thread (kept, so expanding doesn't allocate boards)
+	struct Searcher
+	{
+		MoveGenerator generator;
+		Gameboard board;			// the board being expanded
+		std::uint64_t expanded = 0;	// the # of boards it expanded
+	};
+
+	// add the children of every board in boards (the boards after ply pieces) to
+	//   children: each board with piece # ply placed in each way (& rows cleared)
+	void expand(const BoardCounts& boards, int ply, BoardCounts& children, Searcher& searcher) const;
+
+	// search the subtree of the boards after ply pieces down to depth, adding the
+	//   distinct boards of each ply below it into levels[ply + 1 ..]
+	void search(const BoardCounts& boards, int ply, int depth, std::vector<BoardCounts>& levels, Searcher& searcher) const;
+
+	// return the key of a board / set a board to the occupancy of a key
+	static BoardKey getKey(const Gameboard& board);
+	static void setBoard(const BoardKey& key, Gameboard& board);
+
+	// MEMBER VARIABLES
+	Gameboard root;				// the starting board
+	PieceGenerator pieces;		// the piece sequence
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* PERFT_H */
@@ -0,0 +1,80 @@
+// tetris_perft: count every placement sequence (& distinct board) of the next N pieces
+// from a seeded position, and report how fast they were counted.
+//
+//   tetris_perft [--depth N] [--seed S] [--garbage ROWS] [--threads N] [--verify]
+//
+// The counts are the same on any # of threads (see Perft).
+// --verify runs the reference position to its checked in depth (ignoring --depth, --seed
+// & --garbage) and exits with 1 if any count differs from the checked in ones.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "Perft.h"
+
+// the letter of each shape (in TetShape order)
+static const char SHAPE_LETTERS[] = "SZLJOIT";
+
+// print the command line usage
+static void printUsage() {
+	std::cerr << "usage: tetris_perft [--depth N] [--seed S] [--garbage ROWS] [--threads N] [--verify]\n"
+		<< "  threads: 0 = one per hardware thread (the default is 1)\n"
+		<< "  verify: check the reference position against its checked in counts\n";
+}
+
+int main(int argc, char* argv[])
+{
+	int depth = 3;
+	std::uint64_t seed = Perft::REFERENCE_SEED;
+	int garbageRows = Perft::REFERENCE_GARBAGE_ROWS;
+	int threads = 1;
+	bool verify = false;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--depth") == 0 && hasValue) {
+			depth = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--garbage") == 0 && hasValue) {
+			garbageRows = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--verify") == 0) {
+			verify = true;
+		}
+		else {
+			printUsage();
+			return 2;
+		}
+	}
+	if (verify) {
+		depth = Perft::REFERENCE_DEPTH;
+		seed = Perft::REFERENCE_SEED;
+		garbageRows = Perft::REFERENCE_GARBAGE_ROWS;
+	}
+	if (depth < 1 || garbageRows < 0 || garbageRows >= Gameboard::MAX_Y || threads < 0) {
+		printUsage();
+		return 2;
+	}
+
+	Perft perft(seed, garbageRows);
+	std::cout << "seed: " << seed << "  garbage rows: " << garbageRows << "  pieces:";
+	for (int ply = 0; ply < depth; ply++) {
+		std::cout << " " << SHAPE_LETTERS[perft.getShape(ply)];
+	}
+	std::cout << "\n";
+	PerftResult result = perft.run(depth, threads);
+	Perft::printReport(std::cout, result);
+
+	if (verify) {
+		bool matches = Perft::matchesReference(result);
+		std::cout << (matches ? "verify: counts match the reference\n" : "verify: counts DIFFER from the reference\n");
+		return matches ? 0 : 1;
+	}
+	return 0;
+}
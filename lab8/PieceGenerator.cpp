@@ -0,0 +1,92 @@
+#include "PieceGenerator.h"
+#include "BitUtils.h"
+
+// the splitmix64 Weyl sequence increment (2^64 / golden ratio, odd)
+static const std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+// salts, so keys derived from streams don't collide with plain seeds
+static const std::uint64_t STREAM_SALT = 0xD1B54A32D192ED03ULL;
+static const std::uint64_t SUBSTREAM_SALT = 0x8CB92BA72F3D8DD7ULL;
+
+// constructor, start at the first piece of the stream for seed
+PieceGenerator::PieceGenerator(std::uint64_t seed, std::uint64_t stream) {
+	this->seed = seed;
+	this->stream = stream;
+	key = mix64(seed ^ mix64(stream + STREAM_SALT));
+	bagIndex = 1;	// (anything but 0: force the load)
+	loadBag(0);
+}
+
+// return the next shape in the sequence (and advance)
+TetShape PieceGenerator::next() {
+	TetShape shape = peek();
+	position++;
+	return shape;
+}
+
+// return the next shape in the sequence without advancing
+TetShape PieceGenerator::peek() const {
+	return getShapeAt(position);
+}
+
+// return the shape at any position in the sequence (O(1), the position is unchanged)
+TetShape PieceGenerator::getShapeAt(std::uint64_t position) const {
+	loadBag(position / BAG_SIZE);
+	return bag[position % BAG_SIZE];
+}
+
+// return the # of shapes dealt so far (the position of the next shape)
+std::uint64_t PieceGenerator::getPosition() const {
+	return position;
+}
+// jump to any position in the sequence (forward or back) - O(1)
+void PieceGenerator::setPosition(std::uint64_t position) {
+	this->position = position;
+}
+// skip the next count shapes - O(1)
+void PieceGenerator::skip(std::uint64_t count) {
+	position += count;
+}
+
+// return the seed & stream this generator was created with
+std::uint64_t PieceGenerator::getSeed() const {
+	return seed;
+}
+std::uint64_t PieceGenerator::getStream() const {
+	return stream;
+}
+
+// return a new generator for substream index of this generator's stream
+//   (at position 0). Substreams are independent of each other & their parent,
+//   and a substream of a substream is a new stream again (streams form a tree).
+PieceGenerator PieceGenerator::getSubstream(std::uint64_t index) const {
+	return PieceGenerator(seed, mix64(stream ^ SUBSTREAM_SALT) + mix64(index + GOLDEN_GAMMA));
+}
+
+// the counter-based PRNG: return the 64 random bits at counter for key.
+//   (splitmix64: the finalizer of a Weyl sequence - every call is independent,
+//    so there is no state to step through and nothing to share between threads)
+std::uint64_t PieceGenerator::random(std::uint64_t key, std::uint64_t counter) {
+	return mix64(key + (counter + 1) * GOLDEN_GAMMA);
+}
+
+// fill bag with the shuffle of bag # bagIndex (if it isn't loaded already)
+//   One 64 bit random number per bag: a Fisher-Yates shuffle takes its swap
+//   indices as the digits of that number in the mixed radix 7, 6, ..., 2.
+//   (7! = 5040 permutations from 2^64 values: the bias is under 1 in 10^15)
+void PieceGenerator::loadBag(std::uint64_t bagIndex) const {
+	if (bagIndex == this->bagIndex) {
+		return;
+	}
+	this->bagIndex = bagIndex;
+	for (int i = 0; i < BAG_SIZE; i++) {
+		bag[i] = static_cast<TetShape>(i);
+	}
+	std::uint64_t bits = random(key, bagIndex);
+	for (int i = BAG_SIZE - 1; i > 0; i--) {
+		int j = static_cast<int>(bits % (i + 1));
+		bits /= (i + 1);
+		TetShape swap = bag[i];
+		bag[i] = bag[j];
+		bag[j] = swap;
+	}
+}
@@ -0,0 +1,76 @@
+// The PieceGenerator deals out the sequence of tetromino shapes for one game.
+// Functionality:
+//  - 7-bag randomizer: the shapes come in bags of all 7, each bag shuffled,
+//    so a shape never waits more than 12 pieces (no droughts, no floods).
+//  - Deterministic: the sequence depends only on (seed, stream) - not on rand(),
+//    the platform or the thread - so any game can be replayed from its seed.
+//  - Counter-based: bag b is shuffled with random(key, b), a pure function,
+//    so jumping ahead (or back) any # of pieces is O(1) (setPosition()).
+//  - Splittable: getSubstream(i) makes independent generators from one master
+//    seed, eg: one per game when running thousands of games on many threads.
+//    Generators share no state, so each thread simply owns its own.
+//
+//  [expected .cpp size: ~ 90 lines]
+
+#ifndef PIECEGENERATOR_H
+#define PIECEGENERATOR_H
+
+#include <cstdint>
+#include "Tetromino.h"
+
+class PieceGenerator
+{
+public:
+	static const int BAG_SIZE = TetShape::COUNT;	// # of shapes per bag
+
+	// constructor, start at the first piece of the stream for seed
+	PieceGenerator(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+	// return the next shape in the sequence (and advance)
+	TetShape next();
+
+	// return the next shape in the sequence without advancing
+	TetShape peek() const;
+
+	// return the shape at any position in the sequence (O(1), the position is unchanged)
+	TetShape getShapeAt(std::uint64_t position) const;
+
+	// return the # of shapes dealt so far (the position of the next shape)
+	std::uint64_t getPosition() const;
+	// jump to any position in the sequence (forward or back) - O(1)
+	void setPosition(std::uint64_t position);
+	// skip the next count shapes - O(1)
+	void skip(std::uint64_t count);
+
+	// return the seed & stream this generator was created with
+	std::uint64_t getSeed() const;
+	std::uint64_t getStream() const;
+
+	// return a new generator for substream index of this generator's stream
+	//   (at position 0). Substreams are independent of each other & their parent,
+	//   and a substream of a substream is a new stream again (streams form a tree).
+	PieceGenerator getSubstream(std::uint64_t index) const;
+
+	// the counter-based PRNG: return the 64 random bits at counter for key.
+	//   (splitmix64: the finalizer of a Weyl sequence - every call is independent,
+	//    so there is no state to step through and nothing to share between threads)
+	static std::uint64_t random(std::uint64_t key, std::uint64_t counter);
+
+	// MEMBER VARIABLES
+private:
+	// fill bag with the shuffle of bag # bagIndex (if it isn't loaded already)
+	void loadBag(std::uint64_t bagIndex) const;
+
+	std::uint64_t seed;			// the master seed
+	std::uint64_t stream;		// the stream # (a path in the substream tree, hashed)
+	std::uint64_t key;			// the PRNG key, derived from seed & stream
+	std::uint64_t position = 0;	// the # of shapes dealt so far
+
+	// a cache of the bag being dealt (a pure function of key & bagIndex,
+	//   so the const queries refresh it on demand)
+	mutable std::uint64_t bagIndex = 0;	// the bag currently loaded
+	mutable TetShape bag[BAG_SIZE];		// the shapes of that bag, in dealing order
+
+};
+
+#endif /* PIECEGENERATOR_H */
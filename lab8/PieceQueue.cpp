@@ -0,0 +1,99 @@
+#include <assert.h>
+#include "PieceQueue.h"
+
+static_assert((PieceQueue::CAPACITY & (PieceQueue::CAPACITY - 1)) == 0, "the ring buffer wraps with a mask");
+static_assert(PieceQueue::MAX_PREVIEW + PieceGenerator::BAG_SIZE < PieceQueue::CAPACITY,
+	"a refill must fit while MAX_PREVIEW + 1 shapes are still buffered");
+static_assert(TetShape::COUNT < PieceQueue::NO_PIECE, "every shape needs a 1 byte ID");
+
+// constructor, deal from generator & show previewSize shapes (1..MAX_PREVIEW)
+PieceQueue::PieceQueue(const PieceGenerator& generator, int previewSize) {
+	setPreviewSize(previewSize);
+	reset(generator);
+}
+
+// start over: empty the queue & the hold slot, then deal from generator
+void PieceQueue::reset(const PieceGenerator& generator) {
+	this->generator = generator;
+	head = 0;
+	count = 0;
+	held = NO_PIECE;
+	holdAvailable = true;
+	while (count <= MAX_PREVIEW) {
+		refill();
+	}
+}
+
+// getter & setter for the # of upcoming shapes the game shows (1..MAX_PREVIEW)
+int PieceQueue::getPreviewSize() const {
+	return previewSize;
+}
+void PieceQueue::setPreviewSize(int previewSize) {
+	assert(previewSize >= 1 && previewSize <= MAX_PREVIEW);
+	this->previewSize = previewSize;
+}
+
+// return the shape index places ahead in the queue (0 = the next shape)
+//   index must be < MAX_PREVIEW + 1 (only the preview is guaranteed to be buffered)
+TetShape PieceQueue::peek(int index) const {
+	assert(index >= 0 && index < count);
+	return static_cast<TetShape>(ids[(head + index) & (CAPACITY - 1)]);
+}
+
+// take the next shape off the queue (refilling it a bag at a time when it runs low)
+//   this spawns a new piece, so it makes the hold slot available again.
+TetShape PieceQueue::pop() {
+	holdAvailable = true;
+	return take();
+}
+
+// return true if a shape is in the hold slot
+bool PieceQueue::hasHeld() const {
+	return held != NO_PIECE;
+}
+// return the shape in the hold slot (hasHeld() must be true)
+TetShape PieceQueue::getHeld() const {
+	assert(hasHeld());
+	return static_cast<TetShape>(held);
+}
+// return true if hold() may be called (once per piece)
+bool PieceQueue::canHold() const {
+	return holdAvailable;
+}
+// put current in the hold slot & return the shape to play instead: the
+//   previously held shape, or (if the slot was empty) the next shape in the queue.
+//   canHold() must be true.
+TetShape PieceQueue::hold(TetShape current) {
+	assert(canHold());
+	holdAvailable = false;
+	std::uint8_t previous = held;
+	held = static_cast<std::uint8_t>(current);
+	if (previous == NO_PIECE) {
+		return take();
+	}
+	return static_cast<TetShape>(previous);
+}
+
+// return the generator the queue deals from (positioned after the buffered shapes)
+const PieceGenerator& PieceQueue::getGenerator() const {
+	return generator;
+}
+
+// take the next shape off the front of the ring buffer & refill it if needed
+TetShape PieceQueue::take() {
+	TetShape shape = static_cast<TetShape>(ids[head]);
+	head = (head + 1) & (CAPACITY - 1);
+	count--;
+	if (count <= MAX_PREVIEW) {
+		refill();
+	}
+	return shape;
+}
+
+// add a whole bag from the generator to the back of the ring buffer
+void PieceQueue::refill() {
+	for (int i = 0; i < PieceGenerator::BAG_SIZE; i++) {
+		ids[(head + count) & (CAPACITY - 1)] = static_cast<std::uint8_t>(generator.next());
+		count++;
+	}
+}
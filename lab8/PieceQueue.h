@@ -0,0 +1,76 @@
+// The PieceQueue holds the upcoming shapes of one game (the preview) and the hold slot.
+// Functionality:
+//  - A fixed capacity ring buffer of 1 byte piece IDs (TetShape values): no allocation,
+//    no GridTetromino copies - a whole queue is a couple of cache lines.
+//  - It is refilled from its PieceGenerator a whole bag (7 shapes) at a time, and always
+//    holds at least MAX_PREVIEW + 1 shapes, so any preview size can be peeked at.
+//  - The preview size (1..7) is just how many of them the game shows.
+//  - The hold slot: swap the current shape for the held one (or the next one, the first
+//    time). Only once per piece - pop() (spawning a new piece) makes it available again.
+//
+//  [expected .cpp size: ~ 100 lines]
+
+#ifndef PIECEQUEUE_H
+#define PIECEQUEUE_H
+
+#include <cstdint>
+#include "PieceGenerator.h"
+
+class PieceQueue
+{
+public:
+	static const int MAX_PREVIEW = 7;	// the most upcoming shapes a game can show
+	static const int CAPACITY = 16;		// ring buffer size (a power of 2, > MAX_PREVIEW + BAG_SIZE)
+	static const std::uint8_t NO_PIECE = 0xFF;	// the ID of an empty hold slot
+
+	// constructor, deal from generator & show previewSize shapes (1..MAX_PREVIEW)
+	PieceQueue(const PieceGenerator& generator = PieceGenerator(), int previewSize = 5);
+
+	// start over: empty the queue & the hold slot, then deal from generator
+	void reset(const PieceGenerator& generator);
+
+	// getter & setter for the # of upcoming shapes the game shows (1..MAX_PREVIEW)
+	int getPreviewSize() const;
+	void setPreviewSize(int previewSize);
+
+	// return the shape index places ahead in the queue (0 = the next shape)
+	//   index must be < MAX_PREVIEW + 1 (only the preview is guaranteed to be buffered)
+	TetShape peek(int index = 0) const;
+
+	// take the next shape off the queue (refilling it a bag at a time when it runs low)
+	//   this spawns a new piece, so it makes the hold slot available again.
+	TetShape pop();
+
+	// return true if a shape is in the hold slot
+	bool hasHeld() const;
+	// return the shape in the hold slot (hasHeld() must be true)
+	TetShape getHeld() const;
+	// return true if hold() may be called (once per piece)
+	bool canHold() const;
+	// put current in the hold slot & return the shape to play instead: the
+	//   previously held shape, or (if the slot was empty) the next shape in the queue.
+	//   canHold() must be true.
+	TetShape hold(TetShape current);
+
+	// return the generator the queue deals from (positioned after the buffered shapes)
+	const PieceGenerator& getGenerator() const;
+
+	// MEMBER VARIABLES
+private:
+	// take the next shape off the front of the ring buffer & refill it if needed
+	TetShape take();
+	// add a whole bag from the generator to the back of the ring buffer
+	void refill();
+
+	PieceGenerator generator;		// deals the shapes
+	std::uint8_t ids[CAPACITY];		// the ring buffer of upcoming shapes (TetShape values)
+	int head = 0;					// the index of the next shape in ids
+	int count = 0;					// the # of shapes buffered
+	int previewSize = 5;			// the # of upcoming shapes the game shows
+
+	std::uint8_t held = NO_PIECE;	// the shape in the hold slot (or NO_PIECE)
+	bool holdAvailable = true;		// false once the current piece has been held
+
+};
+
+#endif /* PIECEQUEUE_H */
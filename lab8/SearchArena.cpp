@@ -0,0 +1,56 @@
+#include <assert.h>
+#include "SearchArena.h"
+
+const std::size_t SearchArena::DEFAULT_BLOCK_SIZE;
+
+// constructor, growing by blocks of (at least) blockSize bytes
+SearchArena::SearchArena(std::size_t blockSize) {
+	this->blockSize = blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE;
+}
+
+// forget every allocation (keeping the blocks for the next search)
+void SearchArena::reset() {
+	current = 0;
+	offset = 0;
+	bytesUsed = 0;
+}
+
+// return the # of bytes allocated since the last reset (padding included)
+std::size_t SearchArena::getBytesUsed() const {
+	return bytesUsed;
+}
+
+// return the # of bytes held in blocks
+std::size_t SearchArena::getCapacity() const {
+	std::size_t capacity = 0;
+	for (const Block& block : blocks) {
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+// return bytes bytes of storage aligned to alignment (a power of 2, at most
+//   alignof(std::max_align_t))
+//   Bump the offset in the current block. A request that doesn't fit moves on to the
+//   next block (the rest of the current one goes unused), and if that block is missing
+//   or too small, a new one (at least blockSize bytes) is put in its place first.
+//   (a block's memory is aligned for any type)
+void* SearchArena::allocateBytes(std::size_t bytes, std::size_t alignment) {
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && alignment <= alignof(std::max_align_t));
+	std::size_t start = (offset + alignment - 1) & ~(alignment - 1);
+	if (blocks.empty() || start + bytes > blocks[current].size) {
+		std::size_t next = blocks.empty() ? 0 : current + 1;
+		if (next >= blocks.size() || blocks[next].size < bytes) {
+			Block block;
+			block.size = bytes > blockSize ? bytes : blockSize;
+			block.memory.reset(new unsigned char[block.size]);
+			blocks.insert(blocks.begin() + static_cast<std::ptrdiff_t>(next), std::move(block));
+		}
+		current = next;
+		offset = 0;
+		start = 0;
+	}
+	bytesUsed += start + bytes - offset;
+	offset = start + bytes;
+	return blocks[current].memory.get() + start;
+}
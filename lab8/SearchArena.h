@@ -0,0 +1,69 @@
+// A SearchArena hands out the memory of one search (nodes, candidate lists, scratch
+// arrays) from a few big blocks, by bumping an offset - and takes it all back at once.
+// Functionality:
+//  - allocate<T>(count) returns uninitialized, aligned storage for count Ts (which must
+//    be trivially destructible: nothing is ever destroyed, only forgotten).
+//  - reset() forgets every allocation but keeps the blocks: once a search has grown the
+//    arena to what it needs, later searches of the same size don't touch the heap.
+//  - A request that doesn't fit in the current block moves on to the next kept block,
+//    or (only while the arena is growing) a new one of at least blockSize bytes.
+//
+//  [expected .cpp size: ~ 70 lines]
+
+#ifndef SEARCHARENA_H
+#define SEARCHARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class SearchArena
+{
+public:
+	static const std::size_t DEFAULT_BLOCK_SIZE = 256 * 1024;	// bytes per block
+
+	// constructor, growing by blocks of (at least) blockSize bytes
+	SearchArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+	// return storage for count Ts (uninitialized)
+	template <typename T>
+	T* allocate(std::size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+		return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+	}
+
+	// forget every allocation (keeping the blocks for the next search)
+	void reset();
+
+	// return the # of bytes allocated since the last reset (padding included)
+	std::size_t getBytesUsed() const;
+	// return the # of bytes held in blocks
+	std::size_t getCapacity() const;
+
+private:
+	// one block of memory
+	struct Block
+	{
+		std::unique_ptr<unsigned char[]> memory;
+		std::size_t size;
+	};
+
+	// return bytes bytes of storage aligned to alignment (a power of 2, at most
+	//   alignof(std::max_align_t))
+	void* allocateBytes(std::size_t bytes, std::size_t alignment);
+
+	// MEMBER VARIABLES
+	std::size_t blockSize;			// the least # of bytes of a new block
+	std::vector<Block> blocks;		// every block (kept across resets)
+	std::size_t current = 0;		// the block being allocated from
+	std::size_t offset = 0;			// the # of bytes used in it
+	std::size_t bytesUsed = 0;		// the # of bytes allocated since the last reset
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* SEARCHARENA_H */
@@ -0,0 +1,28 @@
+// A small shape (up to 4 x 4 blocks) stored as a stack of row masks.
+// This is the form the bitboard collision kernel (Gameboard::fits()) works with:
+// a placement is tested by shifting each row mask into place and AND-ing it against
+// the board row it lands on. The gameboard still knows nothing about tetrominoes -
+// a Tetromino hands it the ShapeMask of its current rotation state.
+
+#ifndef SHAPEMASK_H
+#define SHAPEMASK_H
+
+#include <cstdint>
+
+struct ShapeMask
+{
+	static const int ROWS = 4;		// max # of rows in a shape
+	static const int COLUMNS = 4;	// max # of columns in a shape
+
+	// the offset of the mask's first column & row from the shape's origin [0,0]
+	std::int8_t left;
+	std::int8_t top;
+	// rows[i] bit j set = the block at [left + j, top + i] (relative to the origin) is occupied.
+	//   rows[0] is never 0 (top is the shape's topmost row); unused rows are 0.
+	std::uint8_t rows[ROWS];
+	// bottoms[j] = the row (within the mask) of the lowest block in column j,
+	//   or -1 if the column is unused (for Gameboard::getDropDistance())
+	std::int8_t bottoms[COLUMNS];
+};
+
+#endif /* SHAPEMASK_H */
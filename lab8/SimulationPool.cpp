@@ -0,0 +1,150 @@
+#include <assert.h>
+#include <chrono>
+#include <thread>
+#include "SimulationPool.h"
+
+// constructor, threadCount workers (0 = one per hardware thread), each game
+//   ends after maxPiecesPerGame shapes (if it hasn't topped out)
+SimulationPool::SimulationPool(int threadCount, int maxPiecesPerGame) {
+	this->threadCount = resolveThreadCount(threadCount);
+	this->maxPiecesPerGame = maxPiecesPerGame;
+	ranges.reset(new WorkRange[this->threadCount]);
+}
+
+// return the # of worker threads
+int SimulationPool::getThreadCount() const {
+	return threadCount;
+}
+
+// return the # of worker threads a pool made with threadCount has
+//   (0 or less = one per hardware thread, at least 1)
+int SimulationPool::resolveThreadCount(int threadCount) {
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());	// (0 if unknown)
+	}
+	return threadCount > 0 ? threadCount : 1;
+}
+
+// play games 0 .. games - 1 of the batch seeded with masterSeed, on every worker,
+//   each with a policy from makePolicy & return the merged totals.
+//   Fill gameResults (if it isn't null) with each game's result, by game #.
+BatchResult SimulationPool::run(std::uint64_t masterSeed, int games, const PolicyFactory& makePolicy,
+	std::vector<GameResult>* gameResults) {
+	typedef std::chrono::steady_clock Clock;
+	assert(games >= 0);
+	if (gameResults) {
+		gameResults->assign(games, GameResult());	// (each slot is written by exactly one worker)
+	}
+
+	// deal the games out: an equal contiguous range per worker
+	for (int i = 0; i < threadCount; i++) {
+		std::uint32_t begin = static_cast<std::uint32_t>(static_cast<std::int64_t>(games) * i / threadCount);
+		std::uint32_t end = static_cast<std::uint32_t>(static_cast<std::int64_t>(games) * (i + 1) / threadCount);
+		ranges[i].range.store(packRange(begin, end), std::memory_order_relaxed);
+	}
+
+	std::vector<WorkerResult> results(threadCount);
+	Clock::time_point start = Clock::now();
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; i++) {
+		threads.emplace_back(&SimulationPool::work, this, i, masterSeed, std::cref(makePolicy),
+			std::ref(results[i]), gameResults);
+	}
+	work(0, masterSeed, makePolicy, results[0], gameResults);	// (this thread is worker 0)
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// merge the workers' results (they have all finished: nothing to lock)
+	BatchResult total;
+	stealCount = 0;
+	for (int i = 0; i < threadCount; i++) {
+		total.merge(results[i].result);
+		stealCount += results[i].steals;
+	}
+	total.seconds = seconds;
+	return total;
+}
+
+// return the # of successful steals during the last run()
+std::uint64_t SimulationPool::getStealCount() const {
+	return stealCount;
+}
+
+// pack / unpack a range of game #s
+std::uint64_t SimulationPool::packRange(std::uint32_t begin, std::uint32_t end) {
+	return (static_cast<std::uint64_t>(begin) << 32) | end;
+}
+std::uint32_t SimulationPool::getBegin(std::uint64_t range) {
+	return static_cast<std::uint32_t>(range >> 32);
+}
+std::uint32_t SimulationPool::getEnd(std::uint64_t range) {
+	return static_cast<std::uint32_t>(range);
+}
+
+// take the next game # from worker's own range - return false if it is empty
+bool SimulationPool::takeGame(int worker, std::uint32_t& game) {
+	std::atomic<std::uint64_t>& own = ranges[worker].range;
+	std::uint64_t range = own.load(std::memory_order_acquire);
+	while (getBegin(range) < getEnd(range)) {
+		if (own.compare_exchange_weak(range, packRange(getBegin(range) + 1, getEnd(range)),
+			std::memory_order_acq_rel, std::memory_order_acquire)) {
+			game = getBegin(range);
+			return true;
+		}
+	}
+	return false;
+}
+
+// move the back half of another worker's range into worker's (empty) range
+//   return false if every range is empty (the batch is done)
+//   (games are never added, so once every range is seen empty the batch is done: a
+//    range taken by a thief in the meantime is played by that thief)
+bool SimulationPool::stealGames(int worker, std::uint64_t& steals) {
+	for (int i = 1; i < threadCount; i++) {
+		int victim = (worker + i) % threadCount;
+		std::atomic<std::uint64_t>& theirs = ranges[victim].range;
+		std::uint64_t range = theirs.load(std::memory_order_acquire);
+		while (getBegin(range) < getEnd(range)) {
+			std::uint32_t count = getEnd(range) - getBegin(range);
+			std::uint32_t split = getEnd(range) - (count + 1) / 2;
+			if (theirs.compare_exchange_weak(range, packRange(getBegin(range), split),
+				std::memory_order_acq_rel, std::memory_order_acquire)) {
+				// (our range is empty, and thieves never touch an empty range)
+				ranges[worker].range.store(packRange(split, getEnd(range)), std::memory_order_release);
+				steals++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// take the next game # for worker, from its own range or else stolen from another's
+//   return false if every range is empty (the batch is done)
+//   (another thief can empty the range we just stole before we take from it - e.g. a
+//    single game - so keep stealing until there is nothing left to steal)
+bool SimulationPool::nextGame(int worker, std::uint64_t& steals, std::uint32_t& game) {
+	while (!takeGame(worker, game)) {
+		if (!stealGames(worker, steals)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// the body of each worker thread: play games until there are none left to take or steal
+void SimulationPool::work(int worker, std::uint64_t masterSeed, const PolicyFactory& makePolicy,
+	WorkerResult& result, std::vector<GameResult>* gameResults) {
+	std::unique_ptr<GamePolicy> policy = makePolicy();
+	BatchRunner runner(maxPiecesPerGame);
+	std::uint32_t game;
+	while (nextGame(worker, result.steals, game)) {
+		GameResult gameResult = runner.playGame(BatchRunner::getGameSeed(masterSeed, game), *policy, &result.result.pieceLatency);
+		result.result.add(gameResult);
+		if (gameResults) {
+			(*gameResults)[game] = gameResult;
+		}
+	}
+}
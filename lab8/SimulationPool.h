@@ -0,0 +1,99 @@
+// The SimulationPool plays a batch of independent games on many threads at once.
+// Functionality:
+//  - Work stealing: the games are dealt out as one contiguous range per worker.
+//    A worker takes games from the front of its own range; once it runs dry it
+//    steals the back half of another worker's range (one CAS on a packed range),
+//    so the load stays balanced however long each game runs.
+//  - Nothing is shared while games are played: each worker owns its policy, its
+//    simulation & its results (totals + latency histogram). The per worker results
+//    are merged once the workers have finished - no global lock, no shared counters.
+//  - The seed of each game (and so its random policy substream) comes from the
+//    master seed & the game's #, never from the worker that plays it: the results
+//    are the same for any # of threads (only the wall clock time changes).
+//
+//  [expected .cpp size: ~ 150 lines]
+
+#ifndef SIMULATIONPOOL_H
+#define SIMULATIONPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "BatchRunner.h"
+
+class SimulationPool
+{
+public:
+	// makes the policy for one worker (each worker plays with its own instance)
+	typedef std::function<std::unique_ptr<GamePolicy>()> PolicyFactory;
+
+	// constructor, threadCount workers (0 = one per hardware thread), each game
+	//   ends after maxPiecesPerGame shapes (if it hasn't topped out)
+	SimulationPool(int threadCount = 0, int maxPiecesPerGame = BatchRunner::DEFAULT_MAX_PIECES);
+
+	// return the # of worker threads
+	int getThreadCount() const;
+	// return the # of worker threads a pool made with threadCount has
+	//   (0 or less = one per hardware thread, at least 1)
+	static int resolveThreadCount(int threadCount);
+
+	// play games 0 .. games - 1 of the batch seeded with masterSeed, on every worker,
+	//   each with a policy from makePolicy & return the merged totals.
+	//   Fill gameResults (if it isn't null) with each game's result, by game #.
+	BatchResult run(std::uint64_t masterSeed, int games, const PolicyFactory& makePolicy,
+		std::vector<GameResult>* gameResults = nullptr);
+
+	// return the # of successful steals during the last run()
+	std::uint64_t getStealCount() const;
+
+private:
+	// a worker's range of game #s [begin, end), packed in one word so the owner (taking
+	//   from the front) and thieves (stealing from the back) can both update it with a CAS.
+	//   Padded to a cache line of its own: workers poll each other's ranges.
+	struct WorkRange
+	{
+		std::atomic<std::uint64_t> range;
+		char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+	// a worker's results (totals + steals), written only by that worker while it plays.
+	//   Followed by a cache line of padding so neighbouring workers never share a line
+	//   (the vector holding them isn't cache line aligned, so a full line is needed).
+	struct WorkerResult
+	{
+		BatchResult result;
+		std::uint64_t steals = 0;
+		char padding[64];
+	};
+
+	// pack / unpack a range of game #s
+	static std::uint64_t packRange(std::uint32_t begin, std::uint32_t end);
+	static std::uint32_t getBegin(std::uint64_t range);
+	static std::uint32_t getEnd(std::uint64_t range);
+
+	// take the next game # from worker's own range - return false if it is empty
+	bool takeGame(int worker, std::uint32_t& game);
+	// move the back half of another worker's range into worker's (empty) range
+	//   return false if every range is empty (the batch is done)
+	bool stealGames(int worker, std::uint64_t& steals);
+	// take the next game # for worker, from its own range or else stolen from another's
+	//   return false if every range is empty (the batch is done)
+	bool nextGame(int worker, std::uint64_t& steals, std::uint32_t& game);
+
+	// the body of each worker thread: play games until there are none left to take or steal
+	void work(int worker, std::uint64_t masterSeed, const PolicyFactory& makePolicy,
+		WorkerResult& result, std::vector<GameResult>* gameResults);
+
+	int threadCount;				// the # of worker threads
+	int maxPiecesPerGame;			// a game ends after this many shapes
+	std::unique_ptr<WorkRange[]> ranges;	// each worker's range of game #s
+	std::uint64_t stealCount = 0;	// steals during the last run()
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* SIMULATIONPOOL_H */
@@ -0,0 +1,11 @@
+// Runs the TestSuite on its own - no window, no SFML - against the headless
+// simulation core (this is the test program the build registers with ctest).
+
+#undef NDEBUG		// the TestSuite is made of asserts: keep them in every configuration
+#include "TetrisSimulation.h"
+#include "TestSuite.h"
+
+int main()
+{
+	return TestSuite::runTestSuite() ? 0 : 1;
+}
@@ -2,10 +2,30 @@
 #define TESTSUITE_H
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <limits>
+#include <thread>
 #include <assert.h>
+#include "AllocationCounter.h"
 #include "Point.h"
 #include "Tetromino.h"
 #include "GridTetromino.h"
+#include "PieceGenerator.h"
+#include "PieceQueue.h"
+#include "TetrisSimulation.h"
+#include "LatencyHistogram.h"
+#include "BatchRunner.h"
+#include "SimulationPool.h"
+#include "LockstepSimulation.h"
+#include "MoveGenerator.h"
+#include "Perft.h"
+#include "BoardEvaluator.h"
+#include "SearchArena.h"
+#include "BeamSearch.h"
+#include "TranspositionTable.h"
 
 
 #ifdef GAMEBOARD_H
@@ -20,19 +40,1064 @@ public:
 	static bool runTestSuite()
 	{
 		std::cout << "Running TestSuite ------------------------" << "\n";
+		// the "allocates nothing" tests only prove anything if allocations are counted
+		//   (see AllocationCounter: the test build defines TETRIS_COUNT_ALLOCATIONS)
+		assert(AllocationCounter::isEnabled());
 		// run some sanity tests on our classes to ensure they're working as expected.
 		TestSuite::testPointClass();
 		TestSuite::testTetrominoClass();
 		TestSuite::testGridTetrominoClass();
+		TestSuite::testPieceGeneratorClass();
+		TestSuite::testPieceQueueClass();
+		TestSuite::testTickSchedulerClass();
+		TestSuite::testLatencyHistogramClass();
+		TestSuite::testBatchRunnerClass();
+		TestSuite::testSimulationPoolClass();
 
 #ifdef GAMEBOARD_H
 		TestSuite::testGameboardClass();
 #endif
+		TestSuite::testTetrisSimulationClass();
+		TestSuite::testLockstepSimulationClass();
+		TestSuite::testMoveGeneratorClass();
+		TestSuite::testPerftClass();
+		TestSuite::testBoardEvaluatorClass();
+		TestSuite::testSearchArenaClass();
+		TestSuite::testBeamSearchClass();
+		TestSuite::testTranspositionTableClass();
 
 		std::cout << "TestSuite complete -----------------------" << "\n";
 		return true;
 	}
 
+	static bool testPieceGeneratorClass()
+	{
+		std::cout << " testPieceGeneratorClass...";
+
+		PieceGenerator pg(12345);
+		assert(pg.getSeed() == 12345 && pg.getStream() == 0 && pg.getPosition() == 0);
+
+		// test each bag holds every shape exactly once
+		std::vector<TetShape> sequence;
+		for (int bag = 0; bag < 1000; bag++) {
+			int seen = 0;
+			for (int i = 0; i < PieceGenerator::BAG_SIZE; i++) {
+				assert(pg.peek() == pg.getShapeAt(pg.getPosition()));
+				TetShape shape = pg.next();
+				seen |= 1 << shape;
+				sequence.push_back(shape);
+			}
+			assert(seen == (1 << TetShape::COUNT) - 1);
+		}
+		assert(pg.getPosition() == sequence.size());
+
+		// test the sequence is reproducible from the seed, and random access matches it
+		PieceGenerator same(12345);
+		for (std::size_t i = 0; i < sequence.size(); i++) {
+			assert(same.next() == sequence[i]);
+		}
+		for (std::size_t i = sequence.size(); i-- > 0; ) {
+			assert(pg.getShapeAt(i) == sequence[i]);
+		}
+
+		// test jump ahead & back (O(1): no need to deal the pieces in between)
+		same.setPosition(3);
+		assert(same.next() == sequence[3]);
+		same.skip(4000);
+		assert(same.getPosition() == 4004 && same.next() == sequence[4004]);
+		same.setPosition(1ULL << 60);	// far ahead is as cheap as near
+		TetShape far = same.next();
+		assert(same.getShapeAt(1ULL << 60) == far);
+
+		// test other seeds & substreams give other sequences
+		PieceGenerator other(12346);
+		PieceGenerator sub0 = pg.getSubstream(0);
+		PieceGenerator sub1 = pg.getSubstream(1);
+		PieceGenerator sub0again = pg.getSubstream(0);
+		PieceGenerator subsub = sub0.getSubstream(0);
+		int otherSame = 0, subSame = 0, subsubSame = 0;
+		for (std::size_t i = 0; i < 700; i++) {
+			otherSame += other.getShapeAt(i) == sequence[i];
+			subSame += sub0.getShapeAt(i) == sub1.getShapeAt(i);
+			subsubSame += subsub.getShapeAt(i) == sub0.getShapeAt(i);
+			assert(sub0.getShapeAt(i) == sub0again.getShapeAt(i));
+		}
+		// (independent sequences agree about 1 time in 7: 100 of 700)
+		assert(otherSame < 200 && subSame < 200 && subsubSame < 200);
+		assert(sub0.getSeed() == pg.getSeed() && sub0.getStream() != sub1.getStream());
+
+		// test the shapes are evenly shuffled: each shape leads a bag about 1/7 of the time
+		int leads[TetShape::COUNT] = {};
+		for (std::size_t i = 0; i < sequence.size(); i += PieceGenerator::BAG_SIZE) {
+			leads[sequence[i]]++;
+		}
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			assert(leads[shape] > 90 && leads[shape] < 200);	// (expect ~143)
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTetrisSimulationClass()
+	{
+		std::cout << " testTetrisSimulationClass...";
+
+		// test a new game: an empty board & the seed's first shape at the spawn loc
+		TetrisSimulation sim(42);
+		PieceGenerator pg(42);
+		assert(!sim.isGameOver() && sim.getScore() == 0 && sim.getRowsCleared() == 0);
+		assert(sim.getBoard().getAggregateHeight() == 0);
+		assert(sim.getCurrentShape().getShape() == pg.getShapeAt(0));
+		assert(sim.getCurrentShape().getGridLoc().getX() == sim.getBoard().getSpawnLoc().getX());
+		assert(sim.getPieceQueue().peek() == pg.getShapeAt(1));
+
+		// test moves & rotations (an empty board: only the walls stop them)
+		Point spawn = sim.getCurrentShape().getGridLoc();
+		assert(sim.applyAction(ACTION_LEFT) && sim.getCurrentShape().getGridLoc().getX() == spawn.getX() - 1);
+		assert(sim.applyAction(ACTION_RIGHT) && sim.getCurrentShape().getGridLoc().getX() == spawn.getX());
+		assert(sim.applyAction(ACTION_ROTATE_CW) && sim.getCurrentShape().getRotation() == 1);
+		assert(sim.applyAction(ACTION_ROTATE_180) && sim.getCurrentShape().getRotation() == 3);
+		assert(sim.applyAction(ACTION_ROTATE_CCW) && sim.getCurrentShape().getRotation() == 2);
+		while (sim.applyAction(ACTION_LEFT)) {
+		}
+		assert(!sim.applyAction(ACTION_LEFT));
+
+		// test a soft drop scores 1 per row, a hard drop 2 per row, locks & spawns the next shape
+		sim.reset(42);
+		assert(sim.applyAction(ACTION_SOFT_DROP) && sim.getScore() == TetrisSimulation::SOFT_DROP_SCORE);
+		Point ghost = sim.getGhostLoc(sim.getCurrentShape());
+		int rows = ghost.getY() - sim.getCurrentShape().getGridLoc().getY();
+		assert(sim.applyAction(ACTION_HARD_DROP));
+		assert(sim.getScore() == TetrisSimulation::SOFT_DROP_SCORE + TetrisSimulation::HARD_DROP_SCORE * rows);
+		assert(popCountBoard(sim.getBoard()) == Tetromino::BLOCK_COUNT);
+		assert(sim.getCurrentShape().getShape() == pg.getShapeAt(1) && sim.getPieceQueue().canHold());
+
+		// test hold swaps in the next shape
+		assert(sim.applyAction(ACTION_HOLD) && sim.getCurrentShape().getShape() == pg.getShapeAt(2));
+		assert(!sim.applyAction(ACTION_HOLD));
+
+		// test clearing a row: an I dropped into the gap of an almost full bottom row
+		sim.reset(42);
+		sim.currentShape.setShape(TetShape::SHAPE_I);
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			int column = x - sim.currentShape.getGridLoc().getX();
+			if (column < -1 || column > 2) {		// (the I spans columns -1..2)
+				sim.board.setContent(x, Gameboard::MAX_Y - 1, TetColor::RED);
+			}
+		}
+		rows = sim.getGhostLoc(sim.getCurrentShape()).getY() - sim.getCurrentShape().getGridLoc().getY();
+		assert(sim.applyAction(ACTION_HARD_DROP));
+		assert(sim.getRowsCleared() == 1 && sim.getBoard().getAggregateHeight() == 0);
+		assert(sim.getScore() == TetrisSimulation::HARD_DROP_SCORE * rows + TetrisSimulation::ROW_SCORES[1]);
+
+		// test time: each tick that passes moves the shape down a row (a long loop runs them all)
+		sim.reset(42);
+		int y = sim.getCurrentShape().getGridLoc().getY();
+		assert(sim.processGameLoop(sim.getMicrosPerTick() / 2) == 0);
+		assert(sim.getCurrentShape().getGridLoc().getY() == y);
+		assert(sim.processGameLoop(sim.getMicrosPerTick() * 5 / 2) == 3);
+		assert(sim.getCurrentShape().getGridLoc().getY() == y + 3);
+
+		// test the game only depends on the total time, not on how it is split into loops
+		TetrisSimulation bigSteps(3), smallSteps(3);
+		for (int i = 0; i < 200; i++) {
+			bigSteps.processGameLoop(1000003);
+			for (int j = 0; j < 3; j++) {
+				smallSteps.processGameLoop(333334 + (j == 0 ? 1 : 0));
+			}
+			assert(bigSteps.getPositionHash() == smallSteps.getPositionHash());
+			assert(bigSteps.getScheduler().getTickCount() == smallSteps.getScheduler().getTickCount());
+		}
+
+		// test the same seed & actions always play the same game, until it is over
+		TetrisSimulation a(7), b(7);
+		const InputAction actions[] = { ACTION_LEFT, ACTION_ROTATE_CW, ACTION_HARD_DROP, ACTION_RIGHT,
+			ACTION_RIGHT, ACTION_HOLD, ACTION_ROTATE_CCW, ACTION_SOFT_DROP, ACTION_HARD_DROP };
+		for (int i = 0; !a.isGameOver(); i++) {
+			InputAction action = actions[i % (sizeof(actions) / sizeof(actions[0]))];
+			assert(a.applyAction(action) == b.applyAction(action));
+			assert(a.getPositionHash() == b.getPositionHash() && a.getScore() == b.getScore());
+			assert(i < 10000);
+		}
+		assert(b.isGameOver() && !a.applyAction(ACTION_LEFT) && !a.applyAction(ACTION_HARD_DROP));
+
+		// test a reset starts over (the board is emptied)
+		a.reset(7);
+		assert(!a.isGameOver() && a.getScore() == 0 && a.getBoard().getAggregateHeight() == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTickSchedulerClass()
+	{
+		std::cout << " testTickSchedulerClass...";
+
+		TickScheduler ts(1000, 4);
+		assert(ts.getMicrosPerTick() == 1000 && ts.getMaxTicksPerUpdate() == 4);
+
+		// test whole ticks only, the remainder carries over
+		ts.addTime(2500);
+		assert(ts.consumeTick() && ts.consumeTick() && !ts.consumeTick());
+		assert(ts.getPendingMicros() == 500 && ts.getTickCount() == 2);
+		ts.addTime(499);
+		assert(!ts.consumeTick());
+		ts.addTime(1);
+		assert(ts.consumeTick() && !ts.consumeTick() && ts.getPendingMicros() == 0);
+
+		// test the cap: a stall runs maxTicksPerUpdate ticks & drops the rest (keeping the remainder)
+		ts.addTime(10250);
+		int ticks = 0;
+		while (ts.consumeTick()) {
+			ticks++;
+		}
+		assert(ticks == 4 && ts.getDroppedTickCount() == 6 && ts.getPendingMicros() == 250);
+		assert(ts.getTickCount() == 7 && ts.getElapsedMicros() == 13250);
+
+		// test the tick length can change between ticks
+		ts.addTime(3000);
+		assert(ts.consumeTick());
+		ts.setMicrosPerTick(500);
+		assert(ts.consumeTick() && ts.consumeTick() && ts.consumeTick() && !ts.consumeTick());
+		assert(ts.getPendingMicros() == 250 && ts.getDroppedTickCount() == 7);	// (the cap again)
+
+		// test time never runs backwards, and reset()
+		ts.addTime(-5000);
+		assert(ts.getPendingMicros() == 250 && ts.getElapsedMicros() == 16250);
+		ts.reset();
+		assert(ts.getTickCount() == 0 && ts.getDroppedTickCount() == 0 && ts.getElapsedMicros() == 0);
+		assert(ts.getMicrosPerTick() == 500 && ts.getMaxTicksPerUpdate() == 4);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLatencyHistogramClass()
+	{
+		std::cout << " testLatencyHistogramClass...";
+
+		LatencyHistogram h;
+		assert(h.getCount() == 0 && h.getPercentile(50) == 0);
+
+		// test every bucket's range: values map to the bucket whose range holds them
+		for (std::uint64_t value : { 0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 15ULL, 16ULL, 17ULL, 1000ULL, 123456789ULL, ~0ULL }) {
+			int bucket = LatencyHistogram::getBucket(value);
+			assert(bucket >= 0 && bucket < LatencyHistogram::BUCKETS);
+			assert(value <= LatencyHistogram::getBucketMax(bucket));
+			assert(bucket == 0 || value > LatencyHistogram::getBucketMax(bucket - 1));
+		}
+
+		// test percentiles of 1..1000 are within a bucket (12.5%) of the truth
+		for (std::uint64_t value = 1; value <= 1000; value++) {
+			h.record(value);
+		}
+		assert(h.getCount() == 1000 && h.getMax() == 1000 && h.getMean() == 500.5);
+		assert(h.getPercentile(50) >= 500 && h.getPercentile(50) <= 500 * 9 / 8);
+		assert(h.getPercentile(99) >= 990 && h.getPercentile(99) <= 1000);
+		assert(h.getPercentile(100) == 1000);
+
+		// test merging is the same as recording everything in one histogram
+		LatencyHistogram a, b;
+		for (std::uint64_t value = 1; value <= 1000; value++) {
+			(value % 3 ? a : b).record(value);
+		}
+		a.merge(b);
+		assert(a.getCount() == h.getCount() && a.getMax() == h.getMax());
+		for (int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+			assert(a.counts[i] == h.counts[i]);
+		}
+		a.clear();
+		assert(a.getCount() == 0 && a.getMax() == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBatchRunnerClass()
+	{
+		std::cout << " testBatchRunnerClass...";
+
+		// test every policy plays legal, reproducible games
+		BatchRunner runner(300);
+		const char* names[] = { "random", "greedy", "scripted" };
+		for (const char* name : names) {
+			std::unique_ptr<GamePolicy> policy = GamePolicy::create(name, "LLXDHRRZHC");
+			assert(policy && std::string(policy->getName()) == name);
+			GameResult first = runner.playGame(99, *policy);
+			GameResult again = runner.playGame(99, *policy);
+			assert(first.pieces > 0 && first.pieces <= 300 && (first.toppedOut || first.pieces == 300));
+			assert(first.pieces == again.pieces && first.rows == again.rows && first.score == again.score);
+		}
+		assert(!GamePolicy::create("unknown") && !GamePolicy::create("scripted", "LQ"));
+		assert(!GamePolicy::create("scripted", ""));
+
+		// test the greedy policy actually plays: it survives & clears rows
+		GreedyPolicy greedy;
+		GameResult game = runner.playGame(5, greedy);
+		assert(!game.toppedOut && game.pieces == 300 && game.rows >= 100);
+
+		// test a batch: the totals add up & every piece's latency was recorded
+		BatchResult batch = runner.run(1, 0, 3, greedy);
+		BatchResult parts = runner.run(1, 0, 2, greedy);
+		parts.merge(runner.run(1, 2, 1, greedy));
+		assert(batch.games == 3 && batch.pieces == parts.pieces && batch.rows == parts.rows);
+		assert(batch.pieceLatency.getCount() == batch.pieces && parts.pieceLatency.getCount() == parts.pieces);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSimulationPoolClass()
+	{
+		std::cout << " testSimulationPoolClass...";
+
+		// test the results don't depend on the # of threads (or on which worker played a game)
+		SimulationPool::PolicyFactory makeRandom = []() { return GamePolicy::create("random"); };
+		const int GAMES = 23;
+		std::vector<GameResult> single;
+		std::vector<GameResult> multi;
+		SimulationPool one(1, 100);
+		SimulationPool four(4, 100);
+		assert(one.getThreadCount() == 1 && four.getThreadCount() == 4);
+		assert(SimulationPool(0).getThreadCount() == SimulationPool::resolveThreadCount(0));
+		assert(SimulationPool::resolveThreadCount(0) >= 1 && SimulationPool::resolveThreadCount(3) == 3);
+		BatchResult oneTotal = one.run(7, GAMES, makeRandom, &single);
+		BatchResult fourTotal = four.run(7, GAMES, makeRandom, &multi);
+		assert(one.getStealCount() == 0);
+		assert(single.size() == GAMES && multi.size() == GAMES);
+		for (int i = 0; i < GAMES; i++) {
+			// (every game was played exactly once, with its own seed)
+			assert(single[i].seed == BatchRunner::getGameSeed(7, i) && multi[i].seed == single[i].seed);
+			assert(multi[i].pieces == single[i].pieces && multi[i].rows == single[i].rows);
+			assert(multi[i].score == single[i].score && multi[i].toppedOut == single[i].toppedOut);
+		}
+
+		// test the merged totals match a single threaded batch
+		RandomPolicy random;
+		BatchResult batch = BatchRunner(100).run(7, 0, GAMES, random);
+		assert(oneTotal.games == GAMES && fourTotal.games == GAMES);
+		assert(fourTotal.pieces == batch.pieces && fourTotal.rows == batch.rows && fourTotal.score == batch.score);
+		assert(oneTotal.pieces == batch.pieces && fourTotal.toppedOut == batch.toppedOut);
+		assert(fourTotal.pieceLatency.getCount() == batch.pieces);
+
+		// test more threads than games, & an empty batch
+		SimulationPool many(8, 50);
+		assert(many.run(3, 5, makeRandom).games == 5);
+		assert(many.run(3, 0, makeRandom).games == 0);
+
+		// test a worker keeps stealing until every range is empty (a lone game left in
+		//   another worker's range is stolen & played, never dropped)
+		std::uint64_t steals = 0;
+		std::uint32_t game = 0;
+		SimulationPool three(3, 50);
+		three.ranges[0].range.store(SimulationPool::packRange(0, 0));
+		three.ranges[1].range.store(SimulationPool::packRange(2, 2));
+		three.ranges[2].range.store(SimulationPool::packRange(4, 5));
+		assert(three.nextGame(0, steals, game) && game == 4 && steals == 1);
+		assert(!three.nextGame(0, steals, game) && steals == 1);
+		for (int i = 0; i < 50; i++) {
+			// (a few games on many threads: the thieves race for the last games)
+			std::vector<GameResult> results;
+			assert(many.run(i, 1 + i % 9, makeRandom, &results).games == 1 + i % 9);
+			for (std::size_t j = 0; j < results.size(); j++) {
+				assert(results[j].seed == BatchRunner::getGameSeed(i, j));
+			}
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testLockstepSimulationClass()
+	{
+		std::cout << " testLockstepSimulationClass...";
+
+		// test every lane plays exactly the game a TetrisSimulation plays with the same
+		//   seed & actions (37 lanes: the last block of 8 is padded)
+		const int LANES = 37;
+		std::vector<std::uint64_t> seeds;
+		std::vector<TetrisSimulation> games;
+		for (int i = 0; i < LANES; i++) {
+			seeds.push_back(BatchRunner::getGameSeed(11, i));
+			games.push_back(TetrisSimulation(seeds.back()));
+		}
+		LockstepSimulation lockstep(seeds);
+		assert(lockstep.getLaneCount() == LANES && lockstep.getLiveLaneCount() == LANES);
+#ifdef LOCKSTEP_AVX2
+		assert(std::string(LockstepSimulation::getKernelName()) == "avx2");
+#else
+		assert(std::string(LockstepSimulation::getKernelName()) == "scalar");
+#endif
+		GreedyPolicy greedy;	// (plays lane 0 well enough to clear rows - the others follow along)
+		bool clearedRows = false;
+		for (std::uint64_t step = 0; step < 4000 && lockstep.getLiveLaneCount() > 0; step++) {
+			// (mostly lane 0's greedy actions, then any action or a tick, drops a little more often)
+			int draw = static_cast<int>(PieceGenerator::random(3, step) % (2 * ACTION_COUNT + 6));
+			if (draw >= ACTION_COUNT + 3) {
+				draw = games[0].isGameOver() ? ACTION_HARD_DROP : greedy.nextAction(games[0]);
+			}
+			int changed = 0;
+			if (draw >= ACTION_COUNT + 1) {
+				InputAction drop = (draw == ACTION_COUNT + 1) ? ACTION_HARD_DROP : ACTION_SOFT_DROP;
+				for (TetrisSimulation& game : games) {
+					changed += game.applyAction(drop);
+				}
+				assert(lockstep.applyAction(drop) == changed);
+			}
+			else if (draw == ACTION_COUNT) {
+				for (TetrisSimulation& game : games) {
+					game.tick();
+				}
+				lockstep.tick();
+			}
+			else {
+				for (TetrisSimulation& game : games) {
+					changed += game.applyAction(static_cast<InputAction>(draw));
+				}
+				assert(lockstep.applyAction(static_cast<InputAction>(draw)) == changed);
+			}
+			for (int i = 0; i < LANES; i++) {
+				LockstepLane lane = lockstep.getLane(i);
+				const TetrisSimulation& game = games[i];
+				assert(lane.isGameOver() == game.isGameOver() && lane.getScore() == game.getScore());
+				assert(lane.getRowsCleared() == game.getRowsCleared() && lane.getPiecesLocked() == game.getPiecesLocked());
+				assert(lane.getCurrentShape().pack().shape == game.getCurrentShape().pack().shape);
+				assert(lane.getCurrentShape().pack().rotation == game.getCurrentShape().pack().rotation);
+				assert(lane.getCurrentShape().getGridLoc().getX() == game.getCurrentShape().getGridLoc().getX());
+				assert(lane.getCurrentShape().getGridLoc().getY() == game.getCurrentShape().getGridLoc().getY());
+				assert(lane.getPieceQueue().peek(0) == game.getPieceQueue().peek(0));
+				for (int y = 0; y < Gameboard::MAX_Y; y++) {
+					assert(lane.getRowMask(y) == game.getBoard().getRowMask(y));
+				}
+				clearedRows |= game.getRowsCleared() > 0;
+			}
+		}
+		assert(clearedRows);
+
+		// test the padded lanes never play, & a reset starts over
+		for (int lane = LANES; lane < lockstep.paddedCount; lane++) {
+			assert(lockstep.alive[lane] == 0);
+		}
+		lockstep.reset(std::vector<std::uint64_t>(3, 5));
+		assert(lockstep.getLaneCount() == 3 && lockstep.getLiveLaneCount() == 3);
+		assert(lockstep.getLane(2).getPiecesLocked() == 0 && lockstep.getLane(2).getRowMask(Gameboard::MAX_Y - 1) == 0);
+		assert(lockstep.applyAction(ACTION_HARD_DROP) == 3 && lockstep.getLane(1).getPiecesLocked() == 1);
+		assert(lockstep.getLane(0).getRowMask(Gameboard::MAX_Y - 1) == lockstep.getLane(2).getRowMask(Gameboard::MAX_Y - 1));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// return the cells a piece fills (as sorted cell #s), to compare landings
+	static std::vector<int> getPlacementCells(PackedPiece piece)
+	{
+		GridTetromino shape;
+		shape.unpack(piece);
+		std::vector<int> cells;
+		for (const Point& loc : shape.getBlockLocsMappedToGrid()) {
+			cells.push_back((loc.getY() + MoveGenerator::Y_OFFSET + 4) * 64 + loc.getX() + 32);
+		}
+		std::sort(cells.begin(), cells.end());
+		return cells;
+	}
+
+	// return the shortest path length (inputs, counting the hard drop) to every distinct
+	//   landing of shape on board, keyed by its cells: the slow way, a plain breadth first
+	//   search that tries every input from every state with TetrisSimulation's rules
+	static std::map<std::vector<int>, int> findPlacementsByHand(const Gameboard& board, const GridTetromino& shape)
+	{
+		std::map<std::vector<int>, int> landings;
+		std::map<std::vector<int>, int> distances;	// (rotation, x, y) -> # of inputs
+		std::queue<std::vector<int>> states;
+		std::vector<int> start = { shape.getRotation(), shape.getGridLoc().getX(), shape.getGridLoc().getY() };
+		distances[start] = 0;
+		states.push(start);
+		while (!states.empty()) {
+			std::vector<int> state = states.front();
+			states.pop();
+			int distance = distances[state];
+			GridTetromino piece = shape;
+			piece.setRotation(state[0]);
+			piece.setGridLoc(state[1], state[2]);
+			int drop = board.getDropDistance(piece.getShapeMask(), state[1], state[2]);
+			PackedPiece landing = piece.pack();
+			landing.y = static_cast<std::int8_t>(landing.y + drop);
+			std::vector<int> cells = getPlacementCells(landing);
+			if (landings.count(cells) == 0) {
+				landings[cells] = distance + 1;
+			}
+
+			std::vector<std::vector<int>> moves;
+			const int steps[3][2] = { { -1, 0 }, { 1, 0 }, { 0, 1 } };
+			for (const int* step : steps) {
+				if (board.fits(piece.getShapeMask(), state[1] + step[0], state[2] + step[1])) {
+					moves.push_back({ state[0], state[1] + step[0], state[2] + step[1] });
+				}
+			}
+			for (int turns = 1; turns < 4; turns++) {
+				int rotation = (state[0] + turns) % 4;
+				for (int test = 0; test < TetrominoKickTable::TESTS; test++) {
+					int x = state[1] + piece.getKicks(turns)[test].x;
+					int y = state[2] + piece.getKicks(turns)[test].y;
+					if (board.fits(piece.getShapeMask(rotation), x, y)) {
+						moves.push_back({ rotation, x, y });
+						break;
+					}
+				}
+			}
+			for (const std::vector<int>& move : moves) {
+				if (move[2] >= -MoveGenerator::Y_OFFSET && distances.count(move) == 0) {
+					distances[move] = distance + 1;
+					states.push(move);
+				}
+			}
+		}
+		return landings;
+	}
+
+	static bool testMoveGeneratorClass()
+	{
+		std::cout << " testMoveGeneratorClass...";
+		MoveGenerator generator;
+
+		// test the # of distinct placements of each shape on an empty board
+		//   (twins that fill the same cells - eg: the O in all 4 rotations - count once)
+		Gameboard board;
+		const int EMPTY_BOARD_PLACEMENTS[TetShape::COUNT] = { 17, 17, 34, 34, 9, 17, 34 };
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			GridTetromino piece;
+			piece.setShape(static_cast<TetShape>(shape));
+			piece.setGridLoc(board.getSpawnLoc());
+			assert(generator.generate(board, piece) == EMPTY_BOARD_PLACEMENTS[shape]);
+			assert(generator.getPlacement(0).pathLength == 1 && generator.getPath(0)[0] == ACTION_HARD_DROP);
+		}
+
+		// test a tuck: the O can only reach the bottom left corner by sliding under a roof
+		for (int x = 0; x < 4; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 3, RED);
+		}
+		GridTetromino o;
+		o.setShape(SHAPE_O);
+		o.setGridLoc(board.getSpawnLoc());
+		bool tucked = false;
+		for (int i = 0; i < generator.generate(board, o); i++) {
+			std::vector<int> cells = getPlacementCells(generator.getPlacement(i).piece);
+			if (cells == getPlacementCells(PackedPiece{ SHAPE_O, 0, 0, Gameboard::MAX_Y - 1 })) {
+				const InputAction* path = generator.getPath(i);
+				int length = generator.getPlacement(i).pathLength;
+				assert(path[length - 2] == ACTION_LEFT && std::count(path, path + length, ACTION_SOFT_DROP) > 0);
+				tucked = true;
+			}
+		}
+		assert(tucked);
+		assert(generator.generate(board, GridTetromino()) == 0);	// (doesn't fit at [0,0])
+
+		// test on the messy boards of games played with random placements: the placements
+		//   & their path lengths match a search by hand, and every path, replayed in the
+		//   game, locks the piece exactly there
+		int checked = 0;
+		for (std::uint64_t seed = 1; checked < 120; seed++) {
+			TetrisSimulation game(seed);
+			while (!game.isGameOver() && checked < 120) {
+				int count = generator.generate(game.getBoard(), game.getCurrentShape());
+				std::map<std::vector<int>, int> expected = findPlacementsByHand(game.getBoard(), game.getCurrentShape());
+				assert(count > 0 && count == static_cast<int>(expected.size()));
+				for (int i = 0; i < count; i++) {
+					const MoveGenerator::Placement& placement = generator.getPlacement(i);
+					std::vector<int> cells = getPlacementCells(placement.piece);
+					assert(expected.count(cells) == 1 && expected[cells] == placement.pathLength);
+					assert(i == 0 || placement.pathLength >= generator.getPlacement(i - 1).pathLength);
+					if (cells[0] < (MoveGenerator::Y_OFFSET + 4) * 64) {
+						continue;	// (blocks above the board: nothing to compare)
+					}
+					TetrisSimulation replay = game;
+					for (int step = 0; step < placement.pathLength; step++) {
+						assert(replay.applyAction(generator.getPath(i)[step]));
+					}
+					Gameboard expectedBoard = game.getBoard();
+					GridTetromino landing;
+					landing.unpack(placement.piece);
+					expectedBoard.setContent(landing.getBlockLocs(), landing.getGridLoc(), RED);
+					expectedBoard.removeCompletedRows();
+					assert(replay.getPiecesLocked() == game.getPiecesLocked() + 1);
+					for (int y = 0; y < Gameboard::MAX_Y; y++) {
+						assert(replay.getBoard().getRowMask(y) == expectedBoard.getRowMask(y));
+					}
+				}
+				int choice = static_cast<int>(PieceGenerator::random(seed, checked) % count);
+				for (int step = 0; step < generator.getPlacement(choice).pathLength; step++) {
+					game.applyAction(generator.getPath(choice)[step]);
+				}
+				checked++;
+			}
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testPerftClass()
+	{
+		std::cout << " testPerftClass...";
+
+		// test the reference position: garbage rows full but for one hole each, under
+		//   an empty board
+		Perft reference;
+		const Gameboard& root = reference.getRootBoard();
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			bool garbage = y >= Gameboard::MAX_Y - Perft::REFERENCE_GARBAGE_ROWS;
+			assert(root.getRowFillCount(y) == (garbage ? Gameboard::MAX_X - 1 : 0));
+		}
+		assert(reference.getShape(0) == PieceGenerator(Perft::REFERENCE_SEED).getShapeAt(0));
+
+		// test its counts against the checked in ones (the deepest is left to tetris_perft --verify)
+		PerftResult result = reference.run(3);
+		assert(result.paths.size() == 3 && result.distinct.size() == 3);
+		assert(Perft::matchesReference(result));
+		for (int d = 0; d < 3; d++) {
+			assert(result.distinct[d] <= result.paths[d]);
+		}
+		PerftResult wrong = result;
+		wrong.paths[2]++;
+		assert(!Perft::matchesReference(wrong));
+
+		// test depth 1 is every placement of the first piece (none lock out on an empty board)
+		Perft emptyBoard(5, 0);
+		GridTetromino first;
+		first.setShape(emptyBoard.getShape(0));
+		first.setGridLoc(emptyBoard.getRootBoard().getSpawnLoc());
+		MoveGenerator generator;
+		std::uint64_t placements = static_cast<std::uint64_t>(generator.generate(emptyBoard.getRootBoard(), first));
+		PerftResult single = emptyBoard.run(3);
+		assert(single.paths[0] == placements && single.distinct[0] == placements);
+		assert(single.expanded == 1 + single.distinct[0] + single.distinct[1]);
+
+		// test splitting the root over threads gives the same counts
+		for (int threads : { 2, 3 }) {
+			PerftResult split = emptyBoard.run(3, threads);
+			assert(split.threads == threads);
+			assert(split.paths == single.paths && split.distinct == single.distinct);
+		}
+		assert(Perft::matchesReference(reference.run(3, 4)));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// return the features of a board the slow way: from the gameboard's profile, and
+	//   transitions counted cell by cell
+	static BoardFeatures getFeaturesByHand(const Gameboard& board, int rowsCleared)
+	{
+		BoardFeatures features;
+		features.rowsCleared = rowsCleared;
+		features.aggregateHeight = board.getAggregateHeight();
+		features.holes = board.getHoleCount();
+		features.bumpiness = board.getBumpiness();
+		features.wells = board.getWellDepthSum();
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = -1; x < Gameboard::MAX_X; x++) {
+				bool filled = x < 0 || board.getContent(x, y) != Gameboard::EMPTY_BLOCK;
+				bool nextFilled = x + 1 >= Gameboard::MAX_X || board.getContent(x + 1, y) != Gameboard::EMPTY_BLOCK;
+				features.rowTransitions += filled != nextFilled;
+			}
+		}
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			for (int y = -1; y < Gameboard::MAX_Y; y++) {
+				bool filled = y >= 0 && board.getContent(x, y) != Gameboard::EMPTY_BLOCK;
+				bool nextFilled = y + 1 >= Gameboard::MAX_Y || board.getContent(x, y + 1) != Gameboard::EMPTY_BLOCK;
+				features.columnTransitions += filled != nextFilled;
+			}
+		}
+		return features;
+	}
+
+	// return true if two sets of features are the same
+	static bool sameFeatures(const BoardFeatures& a, const BoardFeatures& b)
+	{
+		return a.rowsCleared == b.rowsCleared && a.aggregateHeight == b.aggregateHeight && a.holes == b.holes
+			&& a.bumpiness == b.bumpiness && a.wells == b.wells
+			&& a.rowTransitions == b.rowTransitions && a.columnTransitions == b.columnTransitions;
+	}
+
+	static bool testBoardEvaluatorClass()
+	{
+		std::cout << " testBoardEvaluatorClass...";
+		BoardEvaluator evaluator;
+
+		// test an empty board: a transition at each wall of every row, & at the floor
+		Gameboard board;
+		BoardFeatures empty = evaluator.getFeatures(board);
+		assert(empty.aggregateHeight == 0 && empty.holes == 0 && empty.bumpiness == 0 && empty.wells == 0);
+		assert(empty.rowTransitions == 2 * Gameboard::MAX_Y && empty.columnTransitions == Gameboard::MAX_X);
+		assert(sameFeatures(empty, getFeaturesByHand(board, 0)));
+
+		// test a board with a hole, a well & an overhang
+		//   (columns 0-2 height 3, column 3 a well 3 deep, column 4 height 3 with 2 holes)
+		for (int x = 0; x < 5; x++) {
+			if (x != 3) {
+				board.setContent(x, Gameboard::MAX_Y - 3, RED);
+			}
+		}
+		for (int x = 0; x < 3; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 2, RED);
+			board.setContent(x, Gameboard::MAX_Y - 1, RED);
+		}
+		BoardFeatures features = evaluator.getFeatures(board, 2);
+		assert(features.rowsCleared == 2 && features.aggregateHeight == 12 && features.holes == 2);
+		assert(features.bumpiness == 9 && features.wells == 3);
+		assert(sameFeatures(features, getFeaturesByHand(board, 2)));
+		EvaluatorWeights weights;
+		assert(evaluator.evaluate(board, 2) == evaluator.score(features));
+		assert(evaluator.score(features) == weights.rowsCleared * 2 + weights.aggregateHeight * 12
+			+ weights.holes * 2 + weights.bumpiness * 9 + weights.wells * 3
+			+ weights.rowTransitions * features.rowTransitions + weights.columnTransitions * features.columnTransitions);
+
+		// test every placement on the messy boards of games played with random placements:
+		//   the batched features match those of the board after locking the piece (& removing
+		//   completed rows) on a Gameboard, and lock outs score -infinity
+		MoveGenerator generator;
+		std::vector<PackedPiece> pieces;
+		std::vector<double> scores;
+		std::vector<BoardFeatures> batch;
+		int cleared = 0;
+		for (std::uint64_t seed = 1; seed <= 4; seed++) {
+			TetrisSimulation game(seed);
+			for (int piece = 0; piece < 60 && !game.isGameOver(); piece++) {
+				int count = generator.generate(game.getBoard(), game.getCurrentShape());
+				pieces.clear();
+				for (int i = 0; i < count; i++) {
+					pieces.push_back(generator.getPlacement(i).piece);
+				}
+				scores.assign(count, 0.0);
+				batch.assign(count, BoardFeatures());
+				evaluator.evaluatePlacements(game.getBoard(), pieces.data(), count, scores.data(), batch.data());
+				for (int i = 0; i < count; i++) {
+					GridTetromino landing;
+					landing.unpack(pieces[i]);
+					bool lockedOut = false;
+					for (const Point& loc : landing.getBlockLocsMappedToGrid()) {
+						lockedOut = lockedOut || loc.getY() < 0;
+					}
+					if (lockedOut) {
+						assert(scores[i] == -std::numeric_limits<double>::infinity());
+						continue;
+					}
+					Gameboard after = game.getBoard();
+					after.setContent(landing.getBlockLocs(), landing.getGridLoc(), RED);
+					int rows = after.removeCompletedRows();
+					cleared += rows;
+					assert(sameFeatures(batch[i], getFeaturesByHand(after, rows)));
+					assert(scores[i] == evaluator.score(batch[i]));
+				}
+				int choice = static_cast<int>(PieceGenerator::random(seed, piece) % count);
+				for (int step = 0; step < generator.getPlacement(choice).pathLength; step++) {
+					game.applyAction(generator.getPath(choice)[step]);
+				}
+			}
+		}
+		assert(cleared > 0);
+
+		// test a list longer than a batch: each placement scores the same in any batch
+		Gameboard emptyBoard;
+		GridTetromino t;
+		t.setShape(SHAPE_T);
+		t.setGridLoc(emptyBoard.getSpawnLoc());
+		int count = generator.generate(emptyBoard, t);
+		std::vector<PackedPiece> repeated;
+		while (static_cast<int>(repeated.size()) <= 2 * BoardEvaluator::BATCH_SIZE) {
+			for (int i = 0; i < count; i++) {
+				repeated.push_back(generator.getPlacement(i).piece);
+			}
+		}
+		scores.assign(repeated.size(), 0.0);
+		evaluator.evaluatePlacements(emptyBoard, repeated.data(), static_cast<int>(repeated.size()), scores.data());
+		for (std::size_t i = 0; i < repeated.size(); i++) {
+			assert(scores[i] == scores[i % count] && scores[i] > -std::numeric_limits<double>::infinity());
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSearchArenaClass()
+	{
+		std::cout << " testSearchArenaClass...";
+
+		// test allocations are aligned, don't overlap & are counted
+		SearchArena arena(1024);
+		char* bytes = arena.allocate<char>(3);
+		double* doubles = arena.allocate<double>(4);
+		assert(reinterpret_cast<std::uintptr_t>(doubles) % alignof(double) == 0);
+		assert(reinterpret_cast<char*>(doubles) >= bytes + 3);
+		assert(arena.getBytesUsed() >= 3 + 4 * sizeof(double) && arena.getCapacity() == 1024);
+
+		// test a request bigger than a block gets a block of its own, & a full block moves on
+		int* big = arena.allocate<int>(1000);
+		assert(arena.getCapacity() == 1024 + 1000 * sizeof(int) && arena.blocks.size() == 2);
+		std::fill(big, big + 1000, 7);
+		arena.allocate<char>(1000);
+		assert(arena.blocks.size() == 3 && arena.getCapacity() == 2 * 1024 + 1000 * sizeof(int));
+
+		// test reset keeps the blocks: the same allocations again take no new memory
+		std::size_t capacity = arena.getCapacity();
+		arena.reset();
+		assert(arena.getBytesUsed() == 0);
+		long long allocations = AllocationCounter::getCount();
+		assert(arena.allocate<char>(3) == bytes);
+		arena.allocate<double>(4);
+		arena.allocate<int>(1000);
+		arena.allocate<char>(1000);
+		assert(AllocationCounter::getCount() == allocations && arena.getCapacity() == capacity);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBeamSearchClass()
+	{
+		std::cout << " testBeamSearchClass...";
+
+		// test an I next to a 4 deep well goes down it & clears 4 rows (along its path)
+		TetrisSimulation game(42);
+		game.currentShape.setShape(TetShape::SHAPE_I);
+		for (int y = Gameboard::MAX_Y - 4; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X - 1; x++) {
+				game.board.setContent(x, y, TetColor::RED);
+			}
+		}
+		BeamSearch search(8, 2);
+		assert(search.search(game));
+		assert(search.getDepthReached() == 2 && search.getNodesExpanded() > 1);
+		const InputAction* path = search.getBestPath();
+		assert(search.getBestPathLength() > 0 && path[search.getBestPathLength() - 1] == ACTION_HARD_DROP);
+		for (int i = 0; i < search.getBestPathLength(); i++) {
+			game.applyAction(path[i]);
+		}
+		assert(game.getRowsCleared() == 4 && game.getPiecesLocked() == 1);
+
+		// test a beam wide enough to keep every board holds every distinct board of 2
+		//   pieces (as counted by Perft, from the same seed)
+		const std::uint64_t seed = 5;
+		BeamSearch wide(100000, 2);
+		TetrisSimulation fresh(seed);
+		assert(wide.search(fresh));
+		PerftResult counts = Perft(seed, 0).run(2);
+		assert(static_cast<std::uint64_t>(wide.getLastBeamSize()) == counts.distinct[1]);
+		assert(static_cast<std::uint64_t>(wide.getNodesExpanded()) == 1 + counts.distinct[0]);
+
+		// test the depth is limited by the preview, & a narrow beam keeps beamWidth boards
+		BeamSearch narrow(4, 10);
+		assert(narrow.search(fresh));
+		assert(narrow.getDepthReached() == 1 + fresh.getPieceQueue().getPreviewSize());
+		assert(narrow.getLastBeamSize() == 4);
+
+		// test searching again allocates nothing (the arena & lists have grown already)
+		long long allocations = AllocationCounter::getCount();
+		assert(narrow.search(fresh));
+		assert(AllocationCounter::getCount() == allocations);
+
+		// test a time budget too small for a second depth still yields a placement
+		BeamSearch hurried(16, 6, 1);
+		assert(hurried.search(fresh));
+		assert(hurried.getDepthReached() >= 1 && hurried.getBestPathLength() > 0);
+
+		// test the beam policy plays: it survives & clears rows
+		BatchRunner runner(100);
+		BeamSearchPolicy beam(4, 2);
+		GameResult played = runner.playGame(5, beam);
+		assert(!played.toppedOut && played.pieces == 100 && played.rows >= 30);
+
+		// test a shared table: a search of a position searched before expands only the
+		//   boards before the last depth, & chooses exactly as the first search did
+		TranspositionTable table(1024 * 1024);
+		BeamSearch first(8, 3), second(8, 3);
+		first.setTranspositionTable(&table);
+		second.setTranspositionTable(&table);
+		assert(first.getTranspositionTable() == &table);
+		assert(first.search(fresh));
+		TranspositionStats stats = table.getStats();
+		assert(stats.hits == 0 && stats.stores > 0 && stats.stores == stats.misses);
+		assert(second.search(fresh));
+		assert(table.getStats().hits == stats.misses && table.getStats().stores == stats.stores);
+		assert(second.getNodesExpanded() == first.getNodesExpanded() - static_cast<int>(stats.stores));
+		assert(second.getBestScore() == first.getBestScore());
+		assert(second.getBestPathLength() == first.getBestPathLength());
+		assert(std::equal(first.getBestPath(), first.getBestPath() + first.getBestPathLength(), second.getBestPath()));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// return the entry the stress test of testTranspositionTableClass() stores for a key
+	static TranspositionEntry getStressEntry(std::uint64_t key)
+	{
+		TranspositionEntry entry;
+		entry.score = static_cast<float>(key % 1000) - 500.0f;
+		entry.depth = static_cast<int>(key >> 56) % 8;
+		entry.best.shape = static_cast<std::uint8_t>(key % 7);
+		entry.best.rotation = static_cast<std::uint8_t>((key >> 8) % 4);
+		entry.best.x = static_cast<std::int8_t>((key >> 16) % 12) - 2;
+		entry.best.y = static_cast<std::int8_t>((key >> 24) % 23) - 4;
+		return entry;
+	}
+
+	// return true if two entries are the same
+	static bool sameEntry(const TranspositionEntry& a, const TranspositionEntry& b)
+	{
+		return a.score == b.score && a.depth == b.depth && a.best.shape == b.best.shape
+			&& a.best.rotation == b.best.rotation && a.best.x == b.best.x && a.best.y == b.best.y;
+	}
+
+	static bool testTranspositionTableClass()
+	{
+		std::cout << " testTranspositionTableClass...";
+
+		// test the size: whole cache line buckets, a power of 2 of them within the budget
+		TranspositionTable table(100 * 1000);
+		assert(table.getBucketCount() == 1024 && table.getSizeBytes() == 1024 * 64);
+		assert(table.getSlotCount() == 1024 * TranspositionTable::BUCKET_SLOTS);
+		assert(TranspositionTable(1).getBucketCount() == 1);
+		assert(table.getPolicy() == REPLACE_DEPTH_PREFERRED && table.getOccupancy() == 0.0);
+
+		// test entries come back as stored (negative locs, extreme scores, clamped depth)
+		TranspositionEntry entry = getStressEntry(0x123456789ABCDEF0ULL);
+		entry.best.x = -2;
+		entry.best.y = -4;
+		TranspositionEntry found;
+		assert(!table.probe(42, found));
+		table.store(42, entry);
+		assert(table.probe(42, found) && sameEntry(found, entry));
+		entry.score = -std::numeric_limits<float>::infinity();
+		entry.depth = 1000;
+		table.store(42, entry);
+		entry.depth = TranspositionTable::MAX_DEPTH;
+		assert(table.probe(42, found) && sameEntry(found, entry));
+		assert(table.getOccupancy() == 1.0 / table.getSlotCount());
+
+		// test the key mixes in the shape
+		assert(TranspositionTable::getKey(7, SHAPE_I) != TranspositionTable::getKey(7, SHAPE_O));
+		assert(TranspositionTable::getKey(7, SHAPE_I) != TranspositionTable::getKey(8, SHAPE_I));
+
+		// test depth preferred replacement: in a full bucket the shallowest entry goes,
+		//   for an entry as deep (a collision), and a shallower entry is dropped
+		TranspositionTable one(64);
+		TranspositionEntry deep, shallow;
+		deep.depth = 3;
+		shallow.depth = 2;
+		for (std::uint64_t key = 1; key <= 4; key++) {
+			one.store(key, key == 2 ? shallow : deep);
+		}
+		one.store(5, shallow);
+		assert(one.probe(5, found) && !one.probe(2, found) && one.probe(1, found) && found.depth == 3);
+		TranspositionStats stats = one.getStats();
+		assert(stats.stores == 5 && stats.collisions == 1 && stats.rejected == 0);
+		TranspositionEntry shallowest;
+		one.store(6, shallowest);
+		one.store(5, shallowest);
+		assert(!one.probe(6, found) && one.probe(5, found) && found.depth == 2);
+		stats = one.getStats();
+		assert(stats.stores == 5 && stats.rejected == 2 && stats.collisions == 1);
+		assert(stats.hits == 3 && stats.misses == 2);
+
+		// test always replace: the same entries are all taken
+		TranspositionTable always(64, REPLACE_ALWAYS);
+		for (std::uint64_t key = 1; key <= 4; key++) {
+			always.store(key, deep);
+		}
+		always.store(5, shallow);
+		always.store(5, TranspositionEntry());
+		assert(always.probe(5, found) && found.depth == 0);
+		assert(always.getStats().stores == 6 && always.getStats().collisions == 1 && always.getStats().rejected == 0);
+		always.resetStats();
+		always.clear();
+		assert(always.getStats().stores == 0 && always.getOccupancy() == 0.0 && !always.probe(5, found));
+
+		// test threads racing on a small table never read a torn entry: each key always
+		//   stores the same entry, so a hit must be that entry
+		TranspositionTable shared(16 * 64, REPLACE_ALWAYS);
+		std::vector<std::thread> threads;
+		std::atomic<int> torn(0);
+		for (int t = 0; t < 4; t++) {
+			threads.emplace_back([&shared, &torn, t]() {
+				for (std::uint64_t i = 0; i < 20000; i++) {
+					std::uint64_t key = PieceGenerator::random(static_cast<std::uint64_t>(t % 2), i % 500);
+					TranspositionEntry hit;
+					if (shared.probe(key, hit) && !sameEntry(hit, getStressEntry(key))) {
+						torn++;
+					}
+					shared.store(key, getStressEntry(key));
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		stats = shared.getStats();
+		assert(torn == 0 && stats.hits + stats.misses == 4 * 20000 && stats.hits > 0 && stats.collisions > 0);
+		assert(shared.getOccupancy() > 0.5);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// return the # of blocks on a gameboard
+	static int popCountBoard(const Gameboard& g)
+	{
+		int count = 0;
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				count += g.getContent(x, y) != Gameboard::EMPTY_BLOCK;
+			}
+		}
+		return count;
+	}
+
+	static bool testPieceQueueClass()
+	{
+		std::cout << " testPieceQueueClass...";
+
+		// test the queue deals exactly the generator's sequence (across many refills & wraps)
+		PieceGenerator pg(777);
+		PieceQueue q(pg, 3);
+		assert(q.getPreviewSize() == 3 && !q.hasHeld() && q.canHold());
+		for (int i = 0; i < 200; i++) {
+			for (int ahead = 0; ahead <= PieceQueue::MAX_PREVIEW; ahead++) {
+				assert(q.peek(ahead) == pg.getShapeAt(i + ahead));
+			}
+			assert(q.pop() == pg.getShapeAt(i));
+		}
+		q.setPreviewSize(PieceQueue::MAX_PREVIEW);
+		assert(q.getPreviewSize() == PieceQueue::MAX_PREVIEW);
+
+		// test the hold slot: the first hold takes the next shape, later holds swap
+		q.reset(pg);
+		assert(!q.hasHeld() && q.canHold());
+		TetShape current = q.pop();
+		TetShape next = q.peek();
+		TetShape afterNext = q.peek(1);
+		TetShape played = q.hold(current);
+		assert(played == next && q.hasHeld() && q.getHeld() == current && !q.canHold());
+		assert(q.peek() == afterNext);	// the held shape was taken off the queue
+		played = q.pop();				// (lock the piece: the next one may hold again)
+		assert(played == afterNext && q.canHold());
+		TetShape swapped = q.hold(played);
+		assert(swapped == current && q.getHeld() == afterNext);
+		assert(q.peek() == pg.getShapeAt(3));	// a swap doesn't touch the queue
+
+		// test the queue is small & allocation free (it is copied along with a game)
+		static_assert(sizeof(PieceQueue) <= 128, "a queue fits in two cache lines");
+		long long allocations = AllocationCounter::getCount();
+		PieceQueue copy = q;
+		for (int i = 0; i < 100; i++) {
+			copy.pop();
+		}
+		assert(AllocationCounter::getCount() == allocations);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
 	static bool testGridTetrominoClass()
 	{
 		std::cout << " testGridTetrominoClass...";
@@ -62,6 +1127,45 @@ public:
 		std::vector<Point> locs = gt.getBlockLocsMappedToGrid();
 		assert(locs[0].getX() == 6 && locs[0].getY() == 7);
 
+		// test getBlockLocsMappedToGrid(array) (fills the array in place - no allocation)
+		gt.setShape(TetShape::SHAPE_T);
+		gt.setGridLoc(5, 5);
+		std::array<Point, Tetromino::BLOCK_COUNT> mappedLocs;
+		long long allocations = AllocationCounter::getCount();
+		gt.getBlockLocsMappedToGrid(mappedLocs);
+		assert(AllocationCounter::getCount() == allocations);
+		for (int i = 0; i < Tetromino::BLOCK_COUNT; i++) {
+			assert(mappedLocs[i].getX() == gt.blockLocs[i].getX() + 5 && mappedLocs[i].getY() == gt.blockLocs[i].getY() + 5);
+		}
+
+		// test getHashKey() (shape, rotation & loc all change the key)
+		std::uint64_t key = gt.getHashKey();
+		gt.move(1, 0);
+		assert(gt.getHashKey() != key);
+		gt.move(-1, 0);
+		assert(gt.getHashKey() == key);
+		gt.rotateCW();
+		assert(gt.getHashKey() != key);
+		gt.rotateCCW();
+		assert(gt.getHashKey() == key);
+		gt.setShape(TetShape::SHAPE_S);
+		assert(gt.getHashKey() != key);
+
+		// test pack() / unpack() (and that copies are plain value copies)
+		gt.setShape(TetShape::SHAPE_L);
+		gt.rotateCW();
+		gt.setGridLoc(3, 7);
+		PackedPiece packed = gt.pack();
+		assert(packed.shape == TetShape::SHAPE_L && packed.rotation == 1 && packed.x == 3 && packed.y == 7);
+		GridTetromino unpacked;
+		unpacked.unpack(packed);
+		assert(unpacked.getHashKey() == gt.getHashKey());
+		GridTetromino copy = gt;
+		for (int i = 0; i < Tetromino::BLOCK_COUNT; i++) {
+			assert(copy.blockLocs[i].getX() == gt.blockLocs[i].getX() && copy.blockLocs[i].getY() == gt.blockLocs[i].getY());
+			assert(unpacked.blockLocs[i].getX() == gt.blockLocs[i].getX() && unpacked.blockLocs[i].getY() == gt.blockLocs[i].getY());
+		}
+
 
 		std::cout << "passed!" << "\n";
 		return true;
@@ -110,19 +1214,70 @@ public:
 		assert(t.blockLocs.size() == locCount);
 		t.setShape(TetShape::SHAPE_T);
 		assert(t.blockLocs.size() == locCount);
+		assert(t.getShape() == TetShape::SHAPE_T && t.getRotation() == 0);
 
-
-		// test the rotate functionality of a single block
-		t.blockLocs.clear();
-		t.blockLocs.push_back(Point(1, 2));
-		t.rotateCW();
-		assert(t.blockLocs[0].getX() == 2 && t.blockLocs[0].getY() == -1);
+		// test the rotation count
 		t.rotateCW();
-		assert(t.blockLocs[0].getX() == -1 && t.blockLocs[0].getY() == -2);
-		t.rotateCW();
-		assert(t.blockLocs[0].getX() == -2 && t.blockLocs[0].getY() == 1);
-		t.rotateCW();
-		assert(t.blockLocs[0].getX() == 1 && t.blockLocs[0].getY() == 2);
+		assert(t.getRotation() == 1);
+		t.rotateCCW();
+		t.rotateCCW();
+		assert(t.getRotation() == 3);
+		t.setShape(TetShape::SHAPE_T);
+		assert(t.getRotation() == 0);
+
+
+		// test the rotate functionality (rotation is a table lookup): each block
+		//   must turn 90 degrees clockwise (on screen: y grows downward) around [0,0],
+		//   ie: swapXY() then multiplyX(-1)
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			t.setShape(static_cast<TetShape>(shape));
+			for (int turn = 0; turn < 4; turn++) {
+				std::array<Point, Tetromino::BLOCK_COUNT> expected = t.blockLocs;
+				for (Point& loc : expected) {
+					loc.swapXY();
+					loc.multiplyX(-1);
+				}
+				t.rotateCW();
+				for (int i = 0; i < locCount; i++) {
+					assert(t.blockLocs[i].getX() == expected[i].getX() && t.blockLocs[i].getY() == expected[i].getY());
+				}
+			}
+			assert(t.getRotation() == 0);	// four turns are a full circle
+		}
+
+		// test the SRS wall kicks
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			t.setShape(static_cast<TetShape>(shape));
+			for (int rotation = 0; rotation < 4; rotation++) {
+				t.setRotation(rotation);
+				for (int i = 0; i < TetrominoKickTable::TESTS; i++) {
+					// no turn, no kick
+					assert(t.getKicks(0)[i].x == 0 && t.getKicks(0)[i].y == 0);
+					// turning CCW out of a state kicks back what turning CW into it kicked
+					Tetromino next = t;
+					next.rotateCW();
+					assert(next.getKicks(3)[i].x == -t.getKicks(1)[i].x && next.getKicks(3)[i].y == -t.getKicks(1)[i].y);
+					// two CW turns kick as far as one 180 turn
+					assert(t.getKicks(1)[i].x + next.getKicks(1)[i].x == t.getKicks(2)[i].x
+						&& t.getKicks(1)[i].y + next.getKicks(1)[i].y == t.getKicks(2)[i].y);
+				}
+			}
+		}
+		// the O never appears to rotate: every turn (with its first kick) covers the same blocks
+		t.setShape(TetShape::SHAPE_O);
+		for (int turns = 1; turns < 4; turns++) {
+			const ShapeMask& from = t.getShapeMask();
+			const ShapeMask& to = t.getShapeMask(turns);
+			assert(to.left + t.getKicks(turns)[0].x == from.left && to.top + t.getKicks(turns)[0].y == from.top);
+			for (int row = 0; row < ShapeMask::ROWS; row++) {
+				assert(to.rows[row] == from.rows[row]);
+			}
+		}
+		// a J turned CW is kicked 1 left first, then 1 left & 1 up (y grows downward)
+		t.setShape(TetShape::SHAPE_J);
+		assert(t.getKicks(1)[1].x == -1 && t.getKicks(1)[1].y == 0);
+		assert(t.getKicks(1)[2].x == -1 && t.getKicks(1)[2].y == -1);
+		t.setShape(TetShape::SHAPE_T);
 
 		std::cout << "passed!" << "\n";
 		return true;
@@ -327,6 +1482,182 @@ public:
 		assert(g.getContent(1, 3) == 2);	// row 2 copied into row 3
 		assert(g.getContent(1, 4) == Gameboard::EMPTY_BLOCK);	// row 4 is still empty
 
+		// test clearCompletedRows() (returns the cleared row mask, keeps survivors in order)
+		g.empty();
+		for (int y = Gameboard::MAX_Y - 6; y < Gameboard::MAX_Y; y++) {
+			g.fillRow(y, y % 10);
+		}
+		g.setContent(0, Gameboard::MAX_Y - 5, Gameboard::EMPTY_BLOCK);
+		g.setContent(0, Gameboard::MAX_Y - 3, Gameboard::EMPTY_BLOCK);
+		assert(g.clearCompletedRows() == ((1u << (Gameboard::MAX_Y - 6)) | (1u << (Gameboard::MAX_Y - 4))
+			| (1u << (Gameboard::MAX_Y - 2)) | (1u << (Gameboard::MAX_Y - 1))));
+		assert(g.getContent(1, Gameboard::MAX_Y - 1) == (Gameboard::MAX_Y - 3) % 10);
+		assert(g.getContent(1, Gameboard::MAX_Y - 2) == (Gameboard::MAX_Y - 5) % 10);
+		assert(g.getRowMask(Gameboard::MAX_Y - 3) == 0);
+		assert(g.clearCompletedRows() == 0);
+
+		// test moveRows() (overlapping block move of whole rows)
+		g.empty();
+		g.fillRow(0, 1);
+		g.fillRow(1, 2);
+		g.fillRow(2, 3);
+		g.moveRows(0, 1, 3);
+		assert(g.getContent(Gameboard::MAX_X - 1, 1) == 1 && g.getContent(0, 2) == 2 && g.getContent(0, 3) == 3);
+		assert(g.getRowMask(3) == Gameboard::FULL_ROW && g.getRowMask(4) == 0);
+
+
+		// test getRowFillCount() & takeDirtyRows() (empty() changes every row, & only them)
+		g.empty();
+		assert(g.takeDirtyRows() == Gameboard::ALL_ROWS);
+		assert(g.takeDirtyRows() == 0);
+		assert(Gameboard::ALL_ROWS == (1u << Gameboard::MAX_Y) - 1);
+		BasicGameboard<10, 32> tall;	// (a row for every bit of the mask)
+		assert(tall.takeDirtyRows() == 0xFFFFFFFFu);
+		g.setContent(2, 5, 1);
+		g.setContent(3, 5, 1);
+		g.setContent(3, 7, 1);
+		assert(g.getRowFillCount(5) == 2 && g.getRowFillCount(7) == 1 && g.getRowFillCount(6) == 0);
+		assert(g.takeDirtyRows() == ((1u << 5) | (1u << 7)));
+		assert(g.takeDirtyRows() == 0);
+		g.setContent(3, 7, Gameboard::EMPTY_BLOCK);
+		assert(g.takeDirtyRows() == (1u << 7) && g.getRowFillCount(7) == 0);
+
+		// test clearCompletedRows() only needs the rows touched since the last clear
+		g.empty();
+		g.clearCompletedRows();
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			g.setContent(x, Gameboard::MAX_Y - 1, 1);
+		}
+		g.setContent(0, Gameboard::MAX_Y - 2, 2);
+		g.takeDirtyRows();
+		assert(g.unCheckedRows == ((1u << (Gameboard::MAX_Y - 1)) | (1u << (Gameboard::MAX_Y - 2))));
+		assert(g.clearCompletedRows() == (1u << (Gameboard::MAX_Y - 1)));
+		assert(g.unCheckedRows == 0 && g.getContent(0, Gameboard::MAX_Y - 1) == 2);
+		assert(g.takeDirtyRows() != 0);	// the clear moved rows
+
+		// test the surface profile (heights, holes, wells & bumpiness)
+		g.empty();
+		assert(g.getAggregateHeight() == 0 && g.getHoleCount() == 0 && g.getBumpiness() == 0);
+		assert(g.getWellDepthSum() == 0);
+		g.setContent(0, Gameboard::MAX_Y - 1, 1);	// column 0: height 3 with 1 hole
+		g.setContent(0, Gameboard::MAX_Y - 3, 1);
+		g.setContent(2, Gameboard::MAX_Y - 2, 1);	// column 2: height 2 with 1 hole
+		assert(g.getColumnMask(0) == ((1u << (Gameboard::MAX_Y - 1)) | (1u << (Gameboard::MAX_Y - 3))));
+		assert(g.getColumnHeight(0) == 3 && g.getColumnHoles(0) == 1);
+		assert(g.getColumnHeight(1) == 0 && g.getColumnHoles(1) == 0);
+		assert(g.getColumnHeight(2) == 2 && g.getColumnHoles(2) == 1);
+		assert(g.staleColumns == 0);
+		assert(g.getAggregateHeight() == 5 && g.getHoleCount() == 2);
+		assert(g.getBumpiness() == 3 + 2 + 2);
+		assert(g.getWellDepth(1) == 2 && g.getWellDepth(3) == 0);
+		assert(g.getWellDepth(Gameboard::MAX_X - 1) == 0);
+		assert(g.getWellDepthSum() == 2);	// only column 1 is below both of its neighbours
+		assert(g.isProfileConsistent());
+		for (int x = 1; x < Gameboard::MAX_X; x++) {	// complete the bottom row
+			g.setContent(x, Gameboard::MAX_Y - 1, 2);
+		}
+		assert(g.removeCompletedRows() == 1);	// the profile follows the row removal
+		assert(g.getColumnHeight(0) == 2 && g.getColumnHoles(0) == 1);
+		assert(g.getColumnHeight(2) == 1 && g.getColumnHoles(2) == 0);
+		assert(g.getAggregateHeight() == 3 && g.getHoleCount() == 1);
+		assert(g.isProfileConsistent());
+		g.fillRow(0, 1);
+		assert(g.getColumnHeight(5) == Gameboard::MAX_Y && g.getColumnHoles(5) == Gameboard::MAX_Y - 1);
+		assert(g.isProfileConsistent());
+
+		// test the board hash (incremental, content based)
+		g.empty();
+		assert(g.getHash() == 0);
+		g.setContent(3, Gameboard::MAX_Y - 1, 2);
+		std::uint64_t hash = g.getHash();
+		assert(hash != 0);
+		g.setContent(3, Gameboard::MAX_Y - 1, 4);	// color counts
+		assert(g.getHash() != hash);
+		g.setContent(3, Gameboard::MAX_Y - 1, 2);
+		assert(g.getHash() == hash);
+		g.setContent(3, Gameboard::MAX_Y - 2, 2);	// the same cell content one row up
+		g.setContent(3, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+		assert(g.getHash() != hash && g.isHashConsistent());
+		g.fillRow(Gameboard::MAX_Y - 1, 1);
+		assert(g.isHashConsistent());
+		assert(g.removeCompletedRows() == 1);	// the block drops back to where it started
+		assert(g.getHash() == hash && g.isHashConsistent());
+		g.copyRowIntoRow(Gameboard::MAX_Y - 1, 0);
+		g.moveRows(0, 1, 2);
+		assert(g.isHashConsistent());
+		Gameboard g2;
+		g2.setContent(3, Gameboard::MAX_Y - 1, 2);
+		assert(g2.getHash() == hash);	// equal boards hash equal, however they were built
+		g.empty();
+		assert(g.getHash() == 0 && g.isHashConsistent());
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {	// (clearing every row re-hashes them all)
+			g.fillRow(y, 1);
+		}
+		assert(g.getHash() != 0 && g.isHashConsistent());
+		assert(g.removeCompletedRows() == Gameboard::MAX_Y);
+		assert(g.getHash() == 0 && g.isHashConsistent());
+
+		// test the collision kernel: fits() must agree with the border checks &
+		//   areLocsEmpty() for every shape & rotation, everywhere (including far off the board)
+		for (int y = Gameboard::MAX_Y / 2; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				if ((x * 7 + y * 3) % 4 == 0) {
+					g.setContent(x, y, 1);
+				}
+			}
+		}
+		GridTetromino piece;
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			piece.setShape(static_cast<TetShape>(shape));
+			for (int rotation = 0; rotation < 4; rotation++) {
+				piece.setRotation(rotation);
+				for (int y = -8; y < Gameboard::MAX_Y + 8; y++) {
+					for (int x = -8; x < Gameboard::MAX_X + 8; x++) {
+						bool withinBorders = true;
+						for (const Point& loc : piece.getBlockLocs()) {
+							int bx = loc.getX() + x;
+							int by = loc.getY() + y;
+							withinBorders = withinBorders && bx >= 0 && bx < Gameboard::MAX_X && by < Gameboard::MAX_Y;
+						}
+						bool expected = withinBorders && g.areLocsEmpty(piece.getBlockLocs(), Point(x, y));
+						assert(g.fits(piece.getShapeMask(), x, y) == expected);
+						// test the drop distance against a step by step drop
+						if (expected) {
+							int distance = 0;
+							while (g.fits(piece.getShapeMask(), x, y + distance + 1)) {
+								distance++;
+							}
+							assert(g.getDropDistance(piece.getShapeMask(), x, y) == distance);
+						}
+					}
+				}
+			}
+		}
+		g.removeRow(Gameboard::MAX_Y - 1);	// the walled rows follow row moves
+		piece.setShape(TetShape::SHAPE_O);
+		assert(g.fits(piece.getShapeMask(), 0, 0));
+		g.fillRow(0, 2);
+		assert(!g.fits(piece.getShapeMask(), 0, 0));
+		g.empty();
+		assert(g.fits(piece.getShapeMask(), 0, Gameboard::MAX_Y - 1) && !g.fits(piece.getShapeMask(), 0, Gameboard::MAX_Y));
+
+		// test other board dimensions (the row mask is the narrowest type that fits the width)
+		static_assert(sizeof(TrainingGameboard::RowMask) == 1, "4 wide rows should fit in a byte");
+		static_assert(sizeof(Gameboard::RowMask) == 2, "10 wide rows should fit in 16 bits");
+		static_assert(sizeof(MegaGameboard::RowMask) == 8, "40 wide rows should fit in 64 bits");
+		MegaGameboard mega;
+		mega.fillRow(MegaGameboard::MAX_Y - 1, 3);
+		mega.setContent(MegaGameboard::MAX_X - 1, MegaGameboard::MAX_Y - 2, 1);
+		assert(mega.getRowMask(MegaGameboard::MAX_Y - 1) == MegaGameboard::FULL_ROW);
+		assert(mega.removeCompletedRows() == 1);
+		assert(mega.getContent(MegaGameboard::MAX_X - 1, MegaGameboard::MAX_Y - 1) == 1);
+		GuidelineGameboard guideline;
+		guideline.fillRow(GuidelineGameboard::MAX_Y - 1, 2);
+		guideline.fillRow(GuidelineGameboard::MAX_Y - 2, 2);
+		assert(guideline.clearCompletedRows() == (GuidelineGameboard::RowIndexMask(3) << (GuidelineGameboard::MAX_Y - 2)));
+		TrainingGameboard training;
+		training.fillRow(0, 1);
+		assert(training.getRowMask(0) == 0x0F && training.removeCompletedRows() == 1);
 
 		// test areLocsEmpty()
 		g.empty();
@@ -338,6 +1669,36 @@ public:
 		assert(g.areLocsEmpty(testPoints) == true);  // should return true since all points are empty
 		testPoints.push_back(Point(2, 2));
 		assert(g.areLocsEmpty(testPoints) == false);  // should return false since 2,2 contains content 2
+		testPoints = { Point(0, 2), Point(-1, 2), Point(Gameboard::MAX_X, 2) };
+		assert(g.areLocsEmpty(testPoints) == false);  // column 0 is a valid loc (and contains content)
+
+		// test the in place areLocsEmpty() & setContent() (locs + offset - no allocation)
+		g.empty();
+		std::array<Point, 4> square = { Point(0, 0), Point(1, 0), Point(0, 1), Point(1, 1) };
+		long long allocations = AllocationCounter::getCount();
+		assert(g.areLocsEmpty(square, Point(4, 4)) == true);
+		g.setContent(square, Point(4, 4), 3);
+		assert(g.areLocsEmpty(square, Point(5, 5)) == false);
+		assert(g.areLocsEmpty(square, Point(6, 6)) == true);
+		assert(g.areLocsEmpty(square.data(), 4, 3, 3) == false);
+		assert(AllocationCounter::getCount() == allocations);
+		assert(g.getContent(5, 5) == 3 && g.getContent(4, 4) == 3);
+		std::vector<Point> heapLocs(square.begin(), square.end());	// make sure allocations are counted
+		assert(AllocationCounter::getCount() > allocations);
+		assert(g.areLocsEmpty(heapLocs) == true);
+
+		// test getRowMask() (the occupancy bitboard)
+		g.empty();
+		assert(g.getRowMask(0) == 0);
+		g.setContent(0, 0, 1);
+		g.setContent(3, 0, 2);
+		assert(g.getRowMask(0) == ((1 << 0) | (1 << 3)));
+		g.setContent(0, 0, Gameboard::EMPTY_BLOCK);
+		assert(g.getRowMask(0) == (1 << 3));
+		g.fillRow(1, 4);
+		assert(g.getRowMask(1) == Gameboard::FULL_ROW);
+		g.copyRowIntoRow(0, 1);
+		assert(g.getRowMask(1) == (1 << 3) && g.isRowCompleted(1) == false);
 
 		// lastly do a visual printout of an empty board
 		g.empty();
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include "TetrisSimulation.h"
+
+// score for clearing 0..4 rows at once
+const int TetrisSimulation::ROW_SCORES[5] = { 0, 100, 300, 500, 800 };
+
+const std::int64_t TetrisSimulation::MAX_MICROS_PER_TICK;
+const std::int64_t TetrisSimulation::MIN_MICROS_PER_TICK;
+const std::int64_t TetrisSimulation::MICROS_PER_TICK_STEP;
+
+// constructor
+//   reset the game, seeding the piece queue's generator
+//   (the whole piece sequence follows from the seed)
+TetrisSimulation::TetrisSimulation(std::uint64_t seed) {
+	reset(seed);
+}
+
+// reset everything for a new game
+//  - set score, rows cleared & pieces locked to 0
+//  - determineMicrosPerTick(),
+//  - clear the gameboard,
+//  - reseed the piece queue & spawn the first shape
+void TetrisSimulation::reset(std::uint64_t seed) {
+	score = 0;
+	rowsCleared = 0;
+	piecesLocked = 0;
+	gameOver = false;
+	scheduler.reset();
+	determineMicrosPerTick();
+	board.empty();
+	queue.reset(PieceGenerator(seed));
+	spawnNextShape();
+}
+
+// apply a player action to the currentShape
+//   return true if it did anything (a move/rotation/hold succeeded, or a shape locked)
+//   (no action does anything once the game is over)
+bool TetrisSimulation::applyAction(InputAction action) {
+	if (gameOver) {
+		return false;
+	}
+	switch (action) {
+	case ACTION_LEFT:
+		return attemptMove(currentShape, -1, 0);
+	case ACTION_RIGHT:
+		return attemptMove(currentShape, 1, 0);
+	case ACTION_SOFT_DROP:
+		if (attemptMove(currentShape, 0, 1)) {
+			score += SOFT_DROP_SCORE;
+		}
+		else {
+			lock(currentShape);
+		}
+		return true;
+	case ACTION_HARD_DROP:
+		score += HARD_DROP_SCORE * drop(currentShape);
+		lock(currentShape);
+		return true;
+	case ACTION_ROTATE_CW:
+		return attemptRotate(currentShape, 1);
+	case ACTION_ROTATE_CCW:
+		return attemptRotate(currentShape, 3);
+	case ACTION_ROTATE_180:
+		return attemptRotate(currentShape, 2);
+	case ACTION_HOLD:
+		return attemptHold();
+	default:
+		return false;
+	}
+}
+
+// advance the game clock by elapsedMicros: tick() once for each whole tick
+//   that has passed (up to the scheduler's cap - see setMaxTicksPerLoop()).
+//   return the # of ticks run
+//   (a tick can change the tick length - each tick is asked for separately)
+int TetrisSimulation::processGameLoop(std::int64_t elapsedMicros) {
+	int ticks = 0;
+	scheduler.addTime(elapsedMicros);
+	while (!gameOver && scheduler.consumeTick()) {
+		tick();
+		ticks++;
+	}
+	return ticks;
+}
+
+// A tick() forces the currentShape to move (if there were no tick,
+// the currentShape would float in position forever). This
+// calls attemptMove() on the currentShape. If not successful, the
+// currentShape is locked (it can move no further) & the next one spawned.
+void TetrisSimulation::tick() {
+	if (gameOver) {
+		return;
+	}
+	if (!attemptMove(currentShape, 0, 1)) {
+		lock(currentShape);
+	}
+}
+
+// return true once a new shape could not be spawned
+bool TetrisSimulation::isGameOver() const {
+	return gameOver;
+}
+
+// getters for the score, the total # of rows cleared & the # of shapes locked
+int TetrisSimulation::getScore() const {
+	return score;
+}
+int TetrisSimulation::getRowsCleared() const {
+	return rowsCleared;
+}
+int TetrisSimulation::getPiecesLocked() const {
+	return piecesLocked;
+}
+// getter for the current tick length (in microseconds)
+std::int64_t TetrisSimulation::getMicrosPerTick() const {
+	return scheduler.getMicrosPerTick();
+}
+// set the most ticks one processGameLoop() may run (ticks beyond it are dropped)
+void TetrisSimulation::setMaxTicksPerLoop(int maxTicks) {
+	scheduler.setMaxTicksPerUpdate(maxTicks);
+}
+// return the game clock (elapsed time, ticks run & dropped)
+const TickScheduler& TetrisSimulation::getScheduler() const {
+	return scheduler;
+}
+
+// return the gameboard / the falling tetromino (by reference - no copy is made)
+const Gameboard& TetrisSimulation::getBoard() const {
+	return board;
+}
+const GridTetromino& TetrisSimulation::getCurrentShape() const {
+	return currentShape;
+}
+
+// return the upcoming shapes & the hold slot (by reference - no copy is made)
+const PieceQueue& TetrisSimulation::getPieceQueue() const {
+	return queue;
+}
+
+// return the loc the shape would land at if it were dropped (where its ghost is drawn)
+//   O(1): the gameboard's drop distance scans one column mask per shape column,
+//   so this is cheap enough for every frame (and for the AI).
+Point TetrisSimulation::getGhostLoc(const GridTetromino& shape) const {
+	Point loc = shape.getGridLoc();
+	if (board.fits(shape.getShapeMask(), loc)) {	// (a shape that doesn't fit can't fall)
+		loc.setY(loc.getY() + board.getDropDistance(shape.getShapeMask(), loc));
+	}
+	return loc;
+}
+
+// return a 64 bit hash of the game position: the gameboard content plus the
+//   currentShape's shape, rotation & loc. O(1) (the board hash is incremental).
+std::uint64_t TetrisSimulation::getPositionHash() const {
+	return board.getHash() ^ currentShape.getHashKey();
+}
+
+// take the next shape off the piece queue into the currentShape and set
+//   its loc to be the gameboard's spawn loc.
+//	 - return true/false based on isPositionLegal() (false = game over)
+bool TetrisSimulation::spawnNextShape() {
+	currentShape.setShape(queue.pop());
+	currentShape.setGridLoc(board.getSpawnLoc());
+	if (!isPositionLegal(currentShape)) {
+		gameOver = true;
+	}
+	return !gameOver;
+}
+
+// swap the currentShape for the held shape (or the next shape, the first time)
+//   and move it to the spawn loc. Only once per piece (see PieceQueue::canHold()).
+//	 - return true/false to indicate a successful hold
+bool TetrisSimulation::attemptHold() {
+	if (!queue.canHold()) {
+		return false;
+	}
+	currentShape.setShape(queue.hold(currentShape.getShape()));
+	currentShape.setGridLoc(board.getSpawnLoc());
+	if (!isPositionLegal(currentShape)) {
+		gameOver = true;
+	}
+	return true;
+}
+
+// test if a rotation is legal on the tetromino,
+//   if so, rotate it.
+//  turns = # of clockwise quarter turns (1 = CW, 2 = 180, 3 = CCW)
+//  To do this (without copying or mutating the tetromino until it succeeds):
+//	 1) get the ShapeMask of the target rotation state & the SRS wall kicks (shape.getKicks())
+//	 2) test the target mask at each kicked loc in turn (board.fits()),
+//      the first that fits wins - set the new rotation & loc on the original.
+//	 3) return true/false to indicate successful movement
+bool TetrisSimulation::attemptRotate(GridTetromino& shape, int turns) {
+	int rotation = (shape.getRotation() + turns) % TetrominoRotationTable::ROTATIONS;
+	const ShapeMask& mask = shape.getShapeMask(rotation);
+	const BlockOffset* kicks = shape.getKicks(turns);
+	for (int i = 0; i < TetrominoKickTable::TESTS; i++) {
+		Point loc(shape.getGridLoc().getX() + kicks[i].x, shape.getGridLoc().getY() + kicks[i].y);
+		if (board.fits(mask, loc)) {
+			shape.setRotation(rotation);
+			shape.setGridLoc(loc);
+			return true;
+		}
+	}
+	return false;
+}
+
+// test if a move is legal on the tetromino, if so, move it.
+//  To do this (without copying the tetromino):
+//	 1) test if the shape moved by [x, y] would be legal (isPositionLegal(shape, x, y)),
+//      if so - move the original.
+//	 2) return true/false to indicate successful movement
+bool TetrisSimulation::attemptMove(GridTetromino& shape, int x, int y) {
+	if (isPositionLegal(shape, x, y)) {
+		shape.move(x, y);
+		return true;
+	}
+	else return false;
+}
+
+// drops the tetromino vertically as far as it can
+//   legally go, in one move (see getGhostLoc()).
+//   return the # of rows it fell
+int TetrisSimulation::drop(GridTetromino& shape) {
+	Point loc = getGhostLoc(shape);
+	int rows = loc.getY() - shape.getGridLoc().getY();
+	shape.setGridLoc(loc);
+	return rows;
+}
+
+// copy the contents of the tetromino's block locs to the grid (via gameboard.setContent()),
+//   then remove any rows it completed (only the rows touched since the last lock are
+//   checked, see Gameboard::clearCompletedRows()), score them & spawn the next shape.
+//   Blocks above the board are lost (as in LockstepSimulation): the grid has no row for them.
+void TetrisSimulation::lock(const GridTetromino& shape) {
+	std::array<Point, GridTetromino::BLOCK_COUNT> locs;
+	shape.getBlockLocsMappedToGrid(locs);
+	for (const Point& loc : locs) {
+		if (loc.getY() >= 0) {
+			board.setContent(loc, static_cast<int>(shape.getColor()));
+		}
+	}
+	piecesLocked++;
+	int rows = board.removeCompletedRows();
+	if (rows > 0) {
+		score += ROW_SCORES[std::min(rows, 4)];
+		rowsCleared += rows;
+		determineMicrosPerTick();
+	}
+	spawnNextShape();
+}
+
+// return true if shape is within the left, right & lower borders of the grid
+//	 and does NOT intersect locked blocks (the area above the board is open)
+//   [xOffset, yOffset] tests the shape as if it had been moved by that much.
+//   Both checks are done at once by the gameboard's bitmask collision kernel
+//   (board.fits() with the shape's ShapeMask - a few word operations, no branches).
+bool TetrisSimulation::isPositionLegal(const GridTetromino& shape, int xOffset, int yOffset) const {
+	return board.fits(shape.getShapeMask(),
+		shape.getGridLoc().getX() + xOffset, shape.getGridLoc().getY() + yOffset);
+}
+
+// set the scheduler's tick length
+//   - based on the level (rows cleared / ROWS_PER_LEVEL): each level is faster,
+//     down to MIN_MICROS_PER_TICK
+void TetrisSimulation::determineMicrosPerTick() {
+	std::int64_t level = rowsCleared / ROWS_PER_LEVEL;
+	scheduler.setMicrosPerTick(std::max(MIN_MICROS_PER_TICK, MAX_MICROS_PER_TICK - level * MICROS_PER_TICK_STEP));
+}
@@ -0,0 +1,183 @@
+// This class is the tetris game itself - its rules & state - with no graphics or windowing.
+// It knows nothing about SFML (or any other front end): input arrives as InputActions,
+// time as integer microseconds, and everything a front end needs to draw is available
+// through const getters. Time runs in fixed length ticks (see TickScheduler), so the same
+// seed, actions & elapsed times always produce the same game - at any frame rate, or with
+// no frames at all. TetrisGame is the SFML front end: it draws a TetrisSimulation and feeds it
+// key presses. Headless drivers (tests, batch runs, the AI) use this class directly.
+//
+// This class is responsible for:
+//   - the gameboard,
+//   - spawning, moving, rotating, holding & locking tetrominoes,
+//   - clearing completed rows & scoring,
+//   - ticks (gravity) & game over.
+//
+//  [expected .cpp size: ~ 250 lines]
+
+#ifndef TETRISSIMULATION_H
+#define TETRISSIMULATION_H
+
+#include <cstdint>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PieceQueue.h"
+#include "TickScheduler.h"
+
+// the things a player can do (a front end maps its keys/buttons onto these)
+enum InputAction {
+	ACTION_LEFT,		// move 1 column left
+	ACTION_RIGHT,		// move 1 column right
+	ACTION_SOFT_DROP,	// move 1 row down (lock if it can't)
+	ACTION_HARD_DROP,	// drop as far as it goes & lock
+	ACTION_ROTATE_CW,	// rotate clockwise (SRS wall kicks)
+	ACTION_ROTATE_CCW,	// rotate counter-clockwise
+	ACTION_ROTATE_180,	// rotate 180 degrees
+	ACTION_HOLD,		// swap with the hold slot
+	ACTION_COUNT
+};
+
+class TetrisSimulation
+{
+public:
+	// STATIC CONSTANTS
+	static const int SOFT_DROP_SCORE = 1;		// score per row for a soft drop
+	static const int HARD_DROP_SCORE = 2;		// score per row for a hard drop
+	static const int ROW_SCORES[5];				// score for clearing 0..4 rows at once
+	static const int ROWS_PER_LEVEL = 10;		// the tick speeds up every 10 rows
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   reset the game, seeding the piece queue's generator
+	//   (the whole piece sequence follows from the seed)
+	TetrisSimulation(std::uint64_t seed = 0);
+
+	// reset everything for a new game
+	//  - set score, rows cleared & pieces locked to 0
+	//  - determineMicrosPerTick(),
+	//  - clear the gameboard,
+	//  - reseed the piece queue & spawn the first shape
+	void reset(std::uint64_t seed);
+
+	// apply a player action to the currentShape
+	//   return true if it did anything (a move/rotation/hold succeeded, or a shape locked)
+	//   (no action does anything once the game is over)
+	bool applyAction(InputAction action);
+
+	// advance the game clock by elapsedMicros: tick() once for each whole tick
+	//   that has passed (up to the scheduler's cap - see setMaxTicksPerLoop()).
+	//   return the # of ticks run
+	int processGameLoop(std::int64_t elapsedMicros);
+
+	// A tick() forces the currentShape to move (if there were no tick,
+	// the currentShape would float in position forever). This
+	// calls attemptMove() on the currentShape. If not successful, the
+	// currentShape is locked (it can move no further) & the next one spawned.
+	void tick();
+
+	// return true once a new shape could not be spawned
+	bool isGameOver() const;
+
+	// getters for the score, the total # of rows cleared & the # of shapes locked
+	int getScore() const;
+	int getRowsCleared() const;
+	int getPiecesLocked() const;
+	// getter for the current tick length (in microseconds)
+	std::int64_t getMicrosPerTick() const;
+	// set the most ticks one processGameLoop() may run (ticks beyond it are dropped)
+	void setMaxTicksPerLoop(int maxTicks);
+	// return the game clock (elapsed time, ticks run & dropped)
+	const TickScheduler& getScheduler() const;
+
+	// return the gameboard / the falling tetromino (by reference - no copy is made)
+	const Gameboard& getBoard() const;
+	const GridTetromino& getCurrentShape() const;
+
+	// return the upcoming shapes & the hold slot (by reference - no copy is made)
+	//   peek() at the preview for lookahead: it is a ring buffer of 1 byte IDs.
+	const PieceQueue& getPieceQueue() const;
+
+	// return the loc the shape would land at if it were dropped (where its ghost is drawn)
+	//   O(1): the gameboard's drop distance scans one column mask per shape column,
+	//   so this is cheap enough for every frame (and for the AI).
+	Point getGhostLoc(const GridTetromino &shape) const;
+
+	// return a 64 bit hash of the game position: the gameboard content plus the
+	//   currentShape's shape, rotation & loc. O(1) (the board hash is incremental).
+	std::uint64_t getPositionHash() const;
+
+private:
+	// take the next shape off the piece queue into the currentShape and set
+	//   its loc to be the gameboard's spawn loc.
+	//	 - return true/false based on isPositionLegal() (false = game over)
+	bool spawnNextShape();
+
+	// swap the currentShape for the held shape (or the next shape, the first time)
+	//   and move it to the spawn loc. Only once per piece (see PieceQueue::canHold()).
+	//	 - return true/false to indicate a successful hold
+	bool attemptHold();
+
+	// test if a rotation is legal on the tetromino,
+	//   if so, rotate it.
+	//  turns = # of clockwise quarter turns (1 = CW, 2 = 180, 3 = CCW)
+	//  To do this (without copying or mutating the tetromino until it succeeds):
+	//	 1) get the ShapeMask of the target rotation state & the SRS wall kicks (shape.getKicks())
+	//	 2) test the target mask at each kicked loc in turn (board.fits()),
+	//      the first that fits wins - set the new rotation & loc on the original.
+	//	 3) return true/false to indicate successful movement
+	bool attemptRotate(GridTetromino &shape, int turns = 1);
+
+	// test if a move is legal on the tetromino, if so, move it.
+	//  To do this (without copying the tetromino):
+	//	 1) test if the shape moved by [x, y] would be legal (isPositionLegal(shape, x, y)),
+	//      if so - move the original.
+	//	 2) return true/false to indicate successful movement
+	bool attemptMove(GridTetromino &shape, int x, int y);
+
+	// drops the tetromino vertically as far as it can
+	//   legally go, in one move (see getGhostLoc()).
+	//   return the # of rows it fell
+	int drop(GridTetromino &shape);
+
+	// copy the contents of the tetromino's block locs to the grid (via gameboard.setContent()),
+	//   then remove any rows it completed (only the rows touched since the last lock are
+	//   checked, see Gameboard::clearCompletedRows()), score them & spawn the next shape.
+	void lock(const GridTetromino &shape);
+
+	// return true if shape is within the left, right & lower borders of the grid
+	//	 and does NOT intersect locked blocks (the area above the board is open)
+	//   [xOffset, yOffset] tests the shape as if it had been moved by that much.
+	//   Both checks are done at once by the gameboard's bitmask collision kernel
+	//   (board.fits() with the shape's ShapeMask - a few word operations, no branches).
+	bool isPositionLegal(const GridTetromino &shape, int xOffset = 0, int yOffset = 0) const;
+
+	// set the scheduler's tick length
+	//   - based on the level (rows cleared / ROWS_PER_LEVEL): each level is faster,
+	//     down to MIN_MICROS_PER_TICK
+	void determineMicrosPerTick();
+
+	// MEMBER VARIABLES
+
+	// State members ---------------------------------------------
+	int score = 0;				// the current game score.
+	int rowsCleared = 0;		// the total # of rows cleared this game.
+	int piecesLocked = 0;		// the # of shapes locked this game.
+	bool gameOver = false;		// true once a shape could not be spawned.
+	Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino currentShape;	// the tetromino that is currently falling.
+	PieceQueue queue;			// the upcoming shapes (from a seeded 7-bag) & the hold slot
+
+	// Time members ----------------------------------------------
+	// Note: a "tick" is the amount of time it takes a block to fall one line.
+
+	static const std::int64_t MAX_MICROS_PER_TICK = 750000;	// start off with a slow (max) tick length.
+	static const std::int64_t MIN_MICROS_PER_TICK = 200000;	// this is the fastest tick pace.
+	static const std::int64_t MICROS_PER_TICK_STEP = 50000;	// how much faster each level ticks.
+	TickScheduler scheduler{ MAX_MICROS_PER_TICK };		// the game clock: turns elapsed time into ticks.
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* TETRISSIMULATION_H */
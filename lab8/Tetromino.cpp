@@ -2,6 +2,42 @@
 #include <vector>
 #include "Point.h"
 
+// every shape's rotation states, ShapeMasks & SRS wall kicks, generated at compile time
+constexpr TetrominoRotationTable Tetromino::ROTATION_TABLE;
+constexpr TetrominoMaskTable Tetromino::MASK_TABLE;
+constexpr TetrominoKickTable Tetromino::KICK_TABLE;
+
+// prove the table rotates exactly like the Point based clockwise rotation
+//   (swapXY() then multiplyX(-1): [1,2] -> [-2,1] -> [-1,-2] -> [2,-1] -> [1,2])
+static_assert(Tetromino::ROTATION_TABLE.matchesRotateCW(), "each rotation state must be the previous one turned clockwise");
+static_assert(rotateOffsetCW(BlockOffset{ 1, 2 }).x == -2 && rotateOffsetCW(BlockOffset{ 1, 2 }).y == 1,
+	"rotateCW maps [1,2] to [-2,1]");
+static_assert(Tetromino::ROTATION_TABLE.locs[SHAPE_T][1][0].x == 1 && Tetromino::ROTATION_TABLE.locs[SHAPE_T][1][0].y == 0,
+	"a T turned once clockwise (SRS state R) points its nub right");
+static_assert(TetrominoRotationTable::BLOCKS == Tetromino::BLOCK_COUNT, "the table holds every block of a tetromino");
+
+// prove each ShapeMask (row mask stack) holds the blocks of its rotation state
+static_assert(Tetromino::MASK_TABLE.matches(Tetromino::ROTATION_TABLE), "each ShapeMask must hold exactly the blocks of its rotation state");
+
+// check a few entries against the published SRS kick tables (with y flipped to grow downward)
+//   J, L, S, T, Z 0->R: (0,0) (-1,0) (-1,+1) (0,-2) (-1,-2)   [y up]
+static_assert(Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][1].x == -1 && Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][1].y == 0
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][2].x == -1 && Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][2].y == -1
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][3].x == 0 && Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][3].y == 2
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][4].x == -1 && Tetromino::KICK_TABLE.kicks[SHAPE_T][0][1][4].y == 2,
+	"SRS J/L/S/T/Z 0->R kicks");
+//   I 0->R: (0,0) (-2,0) (+1,0) (-2,-1) (+1,+2)   [y up, relative to the true rotation]
+static_assert(Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][1].x - Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][0].x == -2
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][3].x - Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][0].x == -2
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][3].y - Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][0].y == 1
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][4].x - Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][0].x == 1
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][4].y - Tetromino::KICK_TABLE.kicks[SHAPE_I][0][1][0].y == -2,
+	"SRS I 0->R kicks");
+//   J, L, S, T, Z L->0: (0,0) (-1,0) (-1,-1) (0,+2) (-1,+2)   [y up]
+static_assert(Tetromino::KICK_TABLE.kicks[SHAPE_J][3][1][2].x == -1 && Tetromino::KICK_TABLE.kicks[SHAPE_J][3][1][2].y == 1
+	&& Tetromino::KICK_TABLE.kicks[SHAPE_J][3][1][4].x == -1 && Tetromino::KICK_TABLE.kicks[SHAPE_J][3][1][4].y == -2,
+	"SRS J/L/S/T/Z L->0 kicks");
+
 Tetromino::Tetromino() {
 	setShape(TetShape::SHAPE_S);
 
@@ -15,100 +51,73 @@ TetShape Tetromino::getShape() const {
 	return shape;
 }
 
-TetShape Tetromino::getRandomShape() const {
-	int shapeIndex = rand() % TetShape::COUNT;
-	
-	return static_cast<TetShape>(shapeIndex);
-
+// return the # of clockwise quarter turns from the spawn orientation (0..3)
+int Tetromino::getRotation() const {
+	return rotation;
 }
 
+// set the # of clockwise quarter turns from the spawn orientation (0..3)
+//   (and load the blockLocs for that rotation state)
+void Tetromino::setRotation(int rotation) {
+	this->rotation = rotation % TetrominoRotationTable::ROTATIONS;
+	loadBlockLocs();
+}
 
-void Tetromino::setShape(TetShape shape) {
-	// set the shape
-	//  - clear any blockLocs set previously
-	//  - set the blockLocs for the shape
-	//  - set the color for the shape
-	blockLocs.clear();
-
-	if (shape == TetShape::SHAPE_S) {
-		color = TetColor::RED;
-		//blockLocs = {Point(0,0), Point(0,1).... }
-
-		blockLocs.push_back(Point(-1, 0));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(0, 1));
-		blockLocs.push_back(Point(1, 1));
-	}
-
-	if (shape == TetShape::SHAPE_Z) {
-		color = TetColor::ORANGE;
-
-		blockLocs.push_back(Point(-1, 1));
-		blockLocs.push_back(Point(0, 1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(1, 0));
-	}
-
-	if (shape == TetShape::SHAPE_L) {
-		color = TetColor::YELLOW;
-
-		blockLocs.push_back(Point(0, 2));
-		blockLocs.push_back(Point(0, 1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(1, 0));
-	}
-
-	if (shape == TetShape::SHAPE_J) {
-		color = TetColor::GREEN;
-
-		blockLocs.push_back(Point(-1, -1));
-		blockLocs.push_back(Point(0, -1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(0, 1));
-	}
-
-	if (shape == TetShape::SHAPE_O) {
-		color = TetColor::BLUE_LIGHT;
-
-		blockLocs.push_back(Point(1, 0));
-		blockLocs.push_back(Point(0, 1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(1, 1));
-	}
+// return the blocks of the current shape & rotation as a ShapeMask
+//   (a table lookup - for the bitboard collision kernel, Gameboard::fits())
+const ShapeMask& Tetromino::getShapeMask() const {
+	return MASK_TABLE.masks[shape][rotation];
+}
 
-	if (shape == TetShape::SHAPE_I) {
-		color = TetColor::BLUE_DARK;
+// return the blocks of the current shape in a given rotation state as a ShapeMask
+const ShapeMask& Tetromino::getShapeMask(int rotation) const {
+	return MASK_TABLE.masks[shape][rotation];
+}
 
-		blockLocs.push_back(Point(0, 2));
-		blockLocs.push_back(Point(0, 1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(0, -1));
-	}
+// return the TetrominoKickTable::TESTS wall kicks (translations) to try, in order,
+//   when turning the current shape by turns clockwise quarter turns
+//   (1 = CW, 2 = 180, 3 = CCW) from its current rotation (SRS - a table lookup)
+const BlockOffset* Tetromino::getKicks(int turns) const {
+	return KICK_TABLE.kicks[shape][rotation][turns];
+}
 
-	if (shape == TetShape::SHAPE_T) {
-		color = TetColor::PURPLE;
+// return the block locs (relative to [0,0]) by reference (no copy is made)
+const std::array<Point, Tetromino::BLOCK_COUNT>& Tetromino::getBlockLocs() const {
+	return blockLocs;
+}
 
-		blockLocs.push_back(Point(-1, 0));
-		blockLocs.push_back(Point(0, -1));
-		blockLocs.push_back(Point(0, 0));
-		blockLocs.push_back(Point(1, 0));
-	}
+void Tetromino::setShape(TetShape shape) {
+	// set the shape
+	//  - reset the rotation to the spawn orientation
+	//  - set the blockLocs & color for the shape
+	//    (both are table lookups, see TetrominoRotationTable)
+	this->shape = shape;
+	color = TETROMINO_COLORS[shape];
+	rotation = 0;
+	loadBlockLocs();
 }
 
 void Tetromino::rotateCW() {
 	// rotate the shape 90 degrees around [0,0] (clockwise)
-	// to do this:
-	//  - iterate through blockLocs
-	//  - rotate each Point 90 degrees around [0,0]
-	// hint: rotate the point [1,2] clockwise around [0,0] and note
-	// how the x,y values change. There are 2 functions in the Point
-	// class that can be used to accomplish a rotation.	 
-
-	for (int i = 0; i < blockLocs.size(); i++) {
-		blockLocs[i].multiplyX(-1);
-		blockLocs[i].swapXY();
-	}
+	//  - step to the next rotation state & load its blockLocs
+	//    from the rotation table ([x,y] -> [-y,x] for each block)
+	rotation = (rotation + 1) % TetrominoRotationTable::ROTATIONS;
+	loadBlockLocs();
+}
+
+// rotate the shape 90 degrees around [0,0] (counter clockwise)
+//  (the inverse of rotateCW(), used to undo a rotation in place)
+void Tetromino::rotateCCW() {
+	rotation = (rotation + TetrominoRotationTable::ROTATIONS - 1) % TetrominoRotationTable::ROTATIONS;
+	loadBlockLocs();
+}
 
+// copy the blocks of the current shape & rotation from the rotation table into blockLocs
+void Tetromino::loadBlockLocs() {
+	const BlockOffset* locs = ROTATION_TABLE.locs[shape][rotation];
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		blockLocs[i].setXY(locs[i].x, locs[i].y);
+	}
 }
 
 void Tetromino::printToConsole() const {
@@ -2,7 +2,9 @@
 #define TETROMINO_H
 
 #include <vector>
+#include <array>
 #include "Point.h"
+#include "ShapeMask.h"
 
 
 
@@ -27,16 +29,231 @@ enum TetShape {
 	COUNT
 };
 
+// a block's offset from its tetromino's origin [0,0] (a constexpr friendly Point)
+struct BlockOffset
+{
+	int x;
+	int y;
+};
+
+// the blocks of each shape in its spawn orientation (indexed by TetShape)
+//   These are the SRS spawn states, flat side down, around the block each shape
+//   rotates about (y grows downward, like the gameboard: [0,-1] is above [0,0]).
+constexpr BlockOffset TETROMINO_SPAWN_LOCS[TetShape::COUNT][4] = {
+	{ {0, -1}, {1, -1}, {-1, 0}, {0, 0} },	// SHAPE_S
+	{ {-1, -1}, {0, -1}, {0, 0}, {1, 0} },	// SHAPE_Z
+	{ {1, -1}, {-1, 0}, {0, 0}, {1, 0} },	// SHAPE_L
+	{ {-1, -1}, {-1, 0}, {0, 0}, {1, 0} },	// SHAPE_J
+	{ {0, -1}, {1, -1}, {0, 0}, {1, 0} },	// SHAPE_O
+	{ {-1, 0}, {0, 0}, {1, 0}, {2, 0} },	// SHAPE_I
+	{ {0, -1}, {-1, 0}, {0, 0}, {1, 0} }	// SHAPE_T
+};
+
+// the color of each shape (indexed by TetShape)
+constexpr TetColor TETROMINO_COLORS[TetShape::COUNT] = {
+	RED, ORANGE, YELLOW, GREEN, BLUE_LIGHT, BLUE_DARK, PURPLE
+};
+
+// return an offset rotated 90 degrees clockwise (as seen on screen, where y grows
+//   downward) around [0,0]: [x,y] -> [-y,x]
+constexpr BlockOffset rotateOffsetCW(BlockOffset offset)
+{
+	return BlockOffset{ -offset.y, offset.x };
+}
+
+// the blocks of every shape in each of its 4 rotation states, built at compile time.
+//   locs[shape][rotation] holds the blocks of shape turned clockwise rotation times
+//   (rotation 0 is the spawn orientation), so rotating a tetromino is just a change
+//   of rotation index.
+struct TetrominoRotationTable
+{
+	static const int ROTATIONS = 4;
+	static const int BLOCKS = 4;
+	BlockOffset locs[TetShape::COUNT][ROTATIONS][BLOCKS];
+
+	constexpr TetrominoRotationTable() : locs() {
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			for (int i = 0; i < BLOCKS; i++) {
+				locs[shape][0][i] = TETROMINO_SPAWN_LOCS[shape][i];
+				for (int rotation = 1; rotation < ROTATIONS; rotation++) {
+					locs[shape][rotation][i] = rotateOffsetCW(locs[shape][rotation - 1][i]);
+				}
+			}
+		}
+	}
+
+	// return true if every rotation state is the one before it put through the
+	//   Point based clockwise rotation (swapXY(), then multiplyX(-1)), and four
+	//   turns bring every shape back to its spawn orientation.
+	constexpr bool matchesRotateCW() const {
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			for (int rotation = 0; rotation < ROTATIONS; rotation++) {
+				for (int i = 0; i < BLOCKS; i++) {
+					BlockOffset loc = locs[shape][rotation][i];
+					int x = loc.x;			// swapXY()
+					loc.x = loc.y;
+					loc.y = x;
+					loc.x *= -1;			// multiplyX(-1)
+					const BlockOffset& next = locs[shape][(rotation + 1) % ROTATIONS][i];
+					if (loc.x != next.x || loc.y != next.y) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+};
+
+// the ShapeMask of every shape in each of its 4 rotation states, built at compile
+//   time from the rotation table (for the bitboard collision kernel, Gameboard::fits()).
+struct TetrominoMaskTable
+{
+	ShapeMask masks[TetShape::COUNT][TetrominoRotationTable::ROTATIONS];
+
+	constexpr TetrominoMaskTable(const TetrominoRotationTable& rotations) : masks() {
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			for (int rotation = 0; rotation < TetrominoRotationTable::ROTATIONS; rotation++) {
+				const BlockOffset* locs = rotations.locs[shape][rotation];
+				int left = locs[0].x;
+				int top = locs[0].y;
+				for (int i = 1; i < TetrominoRotationTable::BLOCKS; i++) {
+					left = (locs[i].x < left) ? locs[i].x : left;
+					top = (locs[i].y < top) ? locs[i].y : top;
+				}
+				ShapeMask& mask = masks[shape][rotation];
+				mask.left = static_cast<std::int8_t>(left);
+				mask.top = static_cast<std::int8_t>(top);
+				for (int row = 0; row < ShapeMask::ROWS; row++) {
+					mask.rows[row] = 0;
+				}
+				for (int column = 0; column < ShapeMask::COLUMNS; column++) {
+					mask.bottoms[column] = -1;
+				}
+				for (int i = 0; i < TetrominoRotationTable::BLOCKS; i++) {
+					int row = locs[i].y - top;
+					int column = locs[i].x - left;
+					mask.rows[row] |= static_cast<std::uint8_t>(1u << column);
+					mask.bottoms[column] = static_cast<std::int8_t>((row > mask.bottoms[column]) ? row : mask.bottoms[column]);
+				}
+			}
+		}
+	}
+
+	// return true if every mask holds exactly the blocks of its rotation state
+	//   (and the right lowest block for each of its columns)
+	constexpr bool matches(const TetrominoRotationTable& rotations) const {
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			for (int rotation = 0; rotation < TetrominoRotationTable::ROTATIONS; rotation++) {
+				const ShapeMask& mask = masks[shape][rotation];
+				int bits = 0;
+				for (int row = 0; row < ShapeMask::ROWS; row++) {
+					for (int column = 0; column < ShapeMask::COLUMNS; column++) {
+						bits += (mask.rows[row] >> column) & 1;
+					}
+				}
+				if (bits != TetrominoRotationTable::BLOCKS || mask.rows[0] == 0) {
+					return false;
+				}
+				for (int column = 0; column < ShapeMask::COLUMNS; column++) {
+					int bottom = -1;
+					for (int row = 0; row < ShapeMask::ROWS; row++) {
+						bottom = ((mask.rows[row] >> column) & 1) ? row : bottom;
+					}
+					if (bottom != mask.bottoms[column]) {
+						return false;
+					}
+				}
+				for (int i = 0; i < TetrominoRotationTable::BLOCKS; i++) {
+					const BlockOffset& loc = rotations.locs[shape][rotation][i];
+					if (!((mask.rows[loc.y - mask.top] >> (loc.x - mask.left)) & 1)) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+};
+
+// The SRS (Super Rotation System) offset data of each rotation state (0, R, 2, L), with
+//   y growing downward. Turning a shape from state a to state b tries the translations
+//   offsets[a][n] - offsets[b][n] (n = 0..4) in order, and takes the first that fits:
+//   this is how the standard SRS wall kick tables are derived. (For the I & O shapes the
+//   first translation is never 0: it moves the shape's true center of rotation, which
+//   lies between blocks, back over the block it is rotated about.)
+constexpr BlockOffset SRS_OFFSETS_JLSTZ[4][5] = {
+	{ {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0} },
+	{ {0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2} },
+	{ {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0} },
+	{ {0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2} }
+};
+constexpr BlockOffset SRS_OFFSETS_I[4][5] = {
+	{ {0, 0}, {-1, 0}, {2, 0}, {-1, 0}, {2, 0} },
+	{ {-1, 0}, {0, 0}, {0, 0}, {0, -1}, {0, 2} },
+	{ {-1, -1}, {1, -1}, {-2, -1}, {1, 0}, {-2, 0} },
+	{ {0, -1}, {0, -1}, {0, -1}, {0, 1}, {0, -2} }
+};
+constexpr BlockOffset SRS_OFFSETS_O[4][5] = {	// (the O never kicks: 1 offset per state, repeated)
+	{ {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0} },
+	{ {0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1} },
+	{ {-1, 1}, {-1, 1}, {-1, 1}, {-1, 1}, {-1, 1} },
+	{ {-1, 0}, {-1, 0}, {-1, 0}, {-1, 0}, {-1, 0} }
+};
+
+// the wall kicks of every shape, for every rotation state & turn, built at compile
+//   time from the SRS offset data. kicks[shape][rotation][turns] holds the TESTS
+//   translations to try (in order) when turning shape from rotation by turns
+//   clockwise quarter turns (1 = CW, 2 = 180, 3 = CCW).
+//   SRS defines no 180 kicks: they are derived from the same offsets, which for
+//   J, L, S, T & Z means a 180 turn never kicks.
+struct TetrominoKickTable
+{
+	static const int TESTS = 5;
+	BlockOffset kicks[TetShape::COUNT][TetrominoRotationTable::ROTATIONS][TetrominoRotationTable::ROTATIONS][TESTS];
+
+	constexpr TetrominoKickTable() : kicks() {
+		for (int shape = 0; shape < TetShape::COUNT; shape++) {
+			const BlockOffset (*offsets)[TESTS] = (shape == SHAPE_I) ? SRS_OFFSETS_I
+				: (shape == SHAPE_O) ? SRS_OFFSETS_O : SRS_OFFSETS_JLSTZ;
+			for (int from = 0; from < TetrominoRotationTable::ROTATIONS; from++) {
+				for (int turns = 0; turns < TetrominoRotationTable::ROTATIONS; turns++) {
+					int to = (from + turns) % TetrominoRotationTable::ROTATIONS;
+					for (int n = 0; n < TESTS; n++) {
+						kicks[shape][from][turns][n] = BlockOffset{ offsets[from][n].x - offsets[to][n].x,
+							offsets[from][n].y - offsets[to][n].y };
+					}
+				}
+			}
+		}
+	}
+};
+
 class Tetromino {
 
 friend class TestSuite;
 
+public:
+	static const int BLOCK_COUNT = 4;	// # of blocks in every tetromino
+
+	// the tables of every shape's blocks, ShapeMasks & wall kicks, built at compile time
+	//   (one set for every user: the rule engines, the move generator & the evaluator)
+	static constexpr TetrominoRotationTable ROTATION_TABLE{};
+	static constexpr TetrominoMaskTable MASK_TABLE{ ROTATION_TABLE };
+	static constexpr TetrominoKickTable KICK_TABLE{};
+
 private:
 	TetColor color;
 	TetShape shape;
+	int rotation = 0;	// # of clockwise quarter turns from the spawn orientation (0..3)
+
+	// copy the blocks of the current shape & rotation from the rotation table into blockLocs
+	void loadBlockLocs();
 
 protected:
-	std::vector<Point> blockLocs;
+	// the blocks, stored inline (a tetromino always has exactly 4), so a
+	//  tetromino is trivially copyable and copies never allocate.
+	std::array<Point, BLOCK_COUNT> blockLocs;
 
 public:
 	Tetromino();
@@ -44,22 +261,42 @@ public:
 	TetColor getColor() const;
 
 	TetShape getShape() const;
-	
-	TetShape getRandomShape() const;
+
+	// return the # of clockwise quarter turns from the spawn orientation (0..3)
+	int getRotation() const;
+
+	// set the # of clockwise quarter turns from the spawn orientation (0..3)
+	//   (and load the blockLocs for that rotation state)
+	void setRotation(int rotation);
+
+
+	// return the blocks of the current shape & rotation as a ShapeMask
+	//   (a table lookup - for the bitboard collision kernel, Gameboard::fits())
+	const ShapeMask& getShapeMask() const;
+	// return the blocks of the current shape in a given rotation state as a ShapeMask
+	const ShapeMask& getShapeMask(int rotation) const;
+
+	// return the TetrominoKickTable::TESTS wall kicks (translations) to try, in order,
+	//   when turning the current shape by turns clockwise quarter turns
+	//   (1 = CW, 2 = 180, 3 = CCW) from its current rotation (SRS - a table lookup)
+	const BlockOffset* getKicks(int turns) const;
+
+	// return the block locs (relative to [0,0]) by reference (no copy is made)
+	const std::array<Point, BLOCK_COUNT>& getBlockLocs() const;
 
 
 	void setShape(TetShape shape);// set the shape
-					//  - clear any blockLocs set previously
-					//  - set the blockLocs for the shape
-					//  - set the color for the shape
+					//  - reset the rotation to the spawn orientation
+					//  - set the blockLocs & color for the shape
+					//    (both are table lookups, see TetrominoRotationTable)
 
 	void rotateCW();		// rotate the shape 90 degrees around [0,0] (clockwise)
-					// to do this:
-					//  - iterate through blockLocs
-					//  - rotate each Point 90 degrees around [0,0]
-					// hint: rotate the point [1,2] clockwise around [0,0] and note
-					// how the x,y values change. There are 2 functions in the Point
-					// class that can be used to accomplish a rotation.	 
+					//  - step to the next rotation state & load its blockLocs
+					//    from the rotation table ([x,y] -> [-y,x] for each block)
+					//  (a pure rotation - see getKicks() for the SRS translations)
+
+	void rotateCCW();		// rotate the shape 90 degrees around [0,0] (counter clockwise)
+					//  (the inverse of rotateCW(), used to undo a rotation in place)
 
 	void printToConsole() const;	// print a grid to display the current shape
 					// to do this:
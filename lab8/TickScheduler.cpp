@@ -0,0 +1,79 @@
+#include <assert.h>
+#include "TickScheduler.h"
+
+// constructor, ticks of microsPerTick each, at most maxTicksPerUpdate per addTime()
+TickScheduler::TickScheduler(std::int64_t microsPerTick, int maxTicksPerUpdate) {
+	setMicrosPerTick(microsPerTick);
+	setMaxTicksPerUpdate(maxTicksPerUpdate);
+}
+
+// start over: no time elapsed, no ticks run (the tick length & cap are kept)
+void TickScheduler::reset() {
+	pendingMicros = 0;
+	elapsedMicros = 0;
+	ticksThisUpdate = 0;
+	tickCount = 0;
+	droppedTickCount = 0;
+}
+
+// add elapsedMicros to the time waiting to be ticked & start a new update
+//   (elapsedMicros < 0 is treated as 0: time never runs backwards)
+void TickScheduler::addTime(std::int64_t elapsedMicros) {
+	if (elapsedMicros > 0) {
+		pendingMicros += elapsedMicros;
+		this->elapsedMicros += elapsedMicros;
+	}
+	ticksThisUpdate = 0;
+}
+
+// return true if a whole tick has elapsed (and consume it), false once the time
+//   left is less than a tick - or this update already ran maxTicksPerUpdate ticks,
+//   in which case the whole ticks still waiting are dropped.
+bool TickScheduler::consumeTick() {
+	if (pendingMicros < microsPerTick) {
+		return false;
+	}
+	if (ticksThisUpdate >= maxTicksPerUpdate) {
+		droppedTickCount += static_cast<std::uint64_t>(pendingMicros / microsPerTick);
+		pendingMicros %= microsPerTick;
+		return false;
+	}
+	pendingMicros -= microsPerTick;
+	ticksThisUpdate++;
+	tickCount++;
+	return true;
+}
+
+// getter & setter for the length of a tick in microseconds (> 0)
+std::int64_t TickScheduler::getMicrosPerTick() const {
+	return microsPerTick;
+}
+void TickScheduler::setMicrosPerTick(std::int64_t microsPerTick) {
+	assert(microsPerTick > 0);
+	this->microsPerTick = microsPerTick;
+}
+
+// getter & setter for the most ticks a single update may run (> 0)
+int TickScheduler::getMaxTicksPerUpdate() const {
+	return maxTicksPerUpdate;
+}
+void TickScheduler::setMaxTicksPerUpdate(int maxTicksPerUpdate) {
+	assert(maxTicksPerUpdate > 0);
+	this->maxTicksPerUpdate = maxTicksPerUpdate;
+}
+
+// return the time waiting to be ticked (normally less than a tick between updates)
+std::int64_t TickScheduler::getPendingMicros() const {
+	return pendingMicros;
+}
+// return the total time added since the last reset()
+std::int64_t TickScheduler::getElapsedMicros() const {
+	return elapsedMicros;
+}
+// return the # of ticks run / dropped since the last reset()
+std::uint64_t TickScheduler::getTickCount() const {
+	return tickCount;
+}
+std::uint64_t TickScheduler::getDroppedTickCount() const {
+	return droppedTickCount;
+}
@@ -0,0 +1,73 @@
+// The TickScheduler turns elapsed time into a whole number of fixed length ticks.
+// Functionality:
+//  - Integer time (microseconds): no float accumulation, so the same elapsed times
+//    always produce the same ticks - on any machine, at any frame rate.
+//  - Catches up: a long frame runs every tick that has elapsed (not just one),
+//    up to a cap per update. Whole ticks beyond the cap are dropped (and counted),
+//    so a stall can't make the game spend the next frames catching up.
+//  - The tick length can change between ticks (eg: when the level goes up):
+//    consumeTick() is asked once per tick, so every tick uses the current length.
+//  Usage:
+//		scheduler.addTime(elapsedMicros);
+//		while (scheduler.consumeTick()) {
+//			tick();
+//		}
+//
+//  [expected .cpp size: ~ 80 lines]
+
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <cstdint>
+
+class TickScheduler
+{
+public:
+	static const std::int64_t MICROS_PER_SECOND = 1000000;
+	static const int DEFAULT_MAX_TICKS_PER_UPDATE = 8;
+
+	// constructor, ticks of microsPerTick each, at most maxTicksPerUpdate per addTime()
+	TickScheduler(std::int64_t microsPerTick = MICROS_PER_SECOND, int maxTicksPerUpdate = DEFAULT_MAX_TICKS_PER_UPDATE);
+
+	// start over: no time elapsed, no ticks run (the tick length & cap are kept)
+	void reset();
+
+	// add elapsedMicros to the time waiting to be ticked & start a new update
+	//   (elapsedMicros < 0 is treated as 0: time never runs backwards)
+	void addTime(std::int64_t elapsedMicros);
+
+	// return true if a whole tick has elapsed (and consume it), false once the time
+	//   left is less than a tick - or this update already ran maxTicksPerUpdate ticks,
+	//   in which case the whole ticks still waiting are dropped.
+	bool consumeTick();
+
+	// getter & setter for the length of a tick in microseconds (> 0)
+	std::int64_t getMicrosPerTick() const;
+	void setMicrosPerTick(std::int64_t microsPerTick);
+
+	// getter & setter for the most ticks a single update may run (> 0)
+	int getMaxTicksPerUpdate() const;
+	void setMaxTicksPerUpdate(int maxTicksPerUpdate);
+
+	// return the time waiting to be ticked (normally less than a tick between updates)
+	std::int64_t getPendingMicros() const;
+	// return the total time added since the last reset()
+	std::int64_t getElapsedMicros() const;
+	// return the # of ticks run / dropped since the last reset()
+	std::uint64_t getTickCount() const;
+	std::uint64_t getDroppedTickCount() const;
+
+	// MEMBER VARIABLES
+private:
+	std::int64_t microsPerTick;			// the length of a tick
+	int maxTicksPerUpdate;				// the cap on ticks per addTime()
+
+	std::int64_t pendingMicros = 0;		// time added but not yet ticked
+	std::int64_t elapsedMicros = 0;		// all the time added
+	int ticksThisUpdate = 0;			// ticks run since the last addTime()
+	std::uint64_t tickCount = 0;		// ticks run
+	std::uint64_t droppedTickCount = 0;	// ticks dropped by the cap
+
+};
+
+#endif /* TICKSCHEDULER_H */
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include <new>
+#include "TranspositionTable.h"
+#include "BitUtils.h"
+
+const int TranspositionTable::BUCKET_SLOTS;
+const int TranspositionTable::MAX_DEPTH;
+const std::size_t TranspositionTable::DEFAULT_SIZE;
+
+// the fields of a data word: the score (a float's bits), the depth, the placement
+//   (x & y offset to be unsigned), and a bit that is always set (0 = a free slot)
+static const int DEPTH_SHIFT = 32;
+static const int SHAPE_SHIFT = 40;
+static const int ROTATION_SHIFT = 44;
+static const int X_SHIFT = 46;
+static const int Y_SHIFT = 52;
+static const int LOC_OFFSET = 32;		// x & y are kept as 6 bit values + LOC_OFFSET
+static const std::uint64_t USED_BIT = std::uint64_t(1) << 63;
+
+// constructor, a table of (at most) sizeBytes bytes - at least one bucket - replacing
+//   entries by policy
+//   (the buckets are the largest power of 2 that fits: a key's bucket is its low bits)
+TranspositionTable::TranspositionTable(std::size_t sizeBytes, ReplacementPolicy policy) : policy(policy) {
+	assert(std::atomic<std::uint64_t>().is_lock_free());
+	bucketCount = 1;
+	while (bucketCount * 2 * sizeof(Bucket) <= sizeBytes) {
+		bucketCount *= 2;
+	}
+	memory.reset(new unsigned char[bucketCount * sizeof(Bucket) + alignof(Bucket)]);
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory.get());
+	std::uintptr_t aligned = (address + alignof(Bucket) - 1) & ~static_cast<std::uintptr_t>(alignof(Bucket) - 1);
+	buckets = reinterpret_cast<Bucket*>(aligned);
+	for (std::size_t i = 0; i < bucketCount; i++) {
+		new (&buckets[i]) Bucket;
+	}
+	clear();
+	resetStats();
+}
+
+// return the key of a position: a board (its hash, eg: Gameboard::getOccupancyHash())
+//   & the shape to place on it
+std::uint64_t TranspositionTable::getKey(std::uint64_t boardHash, TetShape shape) {
+	return boardHash ^ mix64(static_cast<std::uint64_t>(shape) + 1);
+}
+
+// look key up: return true & set entry if its position is in the table (thread safe)
+//   A slot holds key's entry if its check XOR its data is key: a slot read half way
+//   through a store doesn't (but for a 1 in 2^64 chance), so it isn't a hit.
+bool TranspositionTable::probe(std::uint64_t key, TranspositionEntry& entry) {
+	Bucket& bucket = getBucket(key);
+	for (Slot& slot : bucket.slots) {
+		std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+		std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+		if (data != 0 && (check ^ data) == key) {
+			entry = unpack(data);
+			hits.value.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	misses.value.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+// store entry for key's position (thread safe: see ReplacementPolicy)
+//   The slot is key's own entry if it has one (replaced by a deeper or as deep entry,
+//   or by any entry with REPLACE_ALWAYS), else a free slot, else the shallowest entry
+//   (see ReplacementPolicy). Racing stores may leave a slot torn: no key matches it,
+//   so it is never read, and is replaced like any other position's entry.
+void TranspositionTable::store(std::uint64_t key, const TranspositionEntry& entry) {
+	Bucket& bucket = getBucket(key);
+	std::uint64_t data = pack(entry);
+	Slot* target = nullptr;		// the slot to write
+	Slot* free = nullptr;		// the first free slot
+	Slot* shallowest = nullptr;	// the shallowest entry
+	int shallowestDepth = MAX_DEPTH + 1;
+	for (Slot& slot : bucket.slots) {
+		std::uint64_t slotData = slot.data.load(std::memory_order_relaxed);
+		std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+		if (slotData != 0 && (check ^ slotData) == key) {
+			target = &slot;
+			break;
+		}
+		if (slotData == 0) {
+			free = free ? free : &slot;
+		}
+		else if (getDepth(slotData) < shallowestDepth) {
+			shallowest = &slot;
+			shallowestDepth = getDepth(slotData);
+		}
+	}
+
+	bool collision = false;
+	if (target) {
+		if (policy == REPLACE_DEPTH_PREFERRED && getDepth(data) < getDepth(target->data.load(std::memory_order_relaxed))) {
+			rejected.value.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+	else if (free) {
+		target = free;
+	}
+	else {
+		if (policy == REPLACE_DEPTH_PREFERRED && getDepth(data) < shallowestDepth) {
+			rejected.value.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		target = shallowest;
+		collision = true;
+	}
+	target->data.store(data, std::memory_order_relaxed);
+	target->check.store(key ^ data, std::memory_order_relaxed);
+	stores.value.fetch_add(1, std::memory_order_relaxed);
+	if (collision) {
+		collisions.value.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+// empty the table (not thread safe: no other thread may use it meanwhile)
+void TranspositionTable::clear() {
+	for (std::size_t i = 0; i < bucketCount; i++) {
+		for (Slot& slot : buckets[i].slots) {
+			slot.check.store(0, std::memory_order_relaxed);
+			slot.data.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+// return the replacement policy, the # of buckets, slots & bytes
+ReplacementPolicy TranspositionTable::getPolicy() const {
+	return policy;
+}
+
+std::size_t TranspositionTable::getBucketCount() const {
+	return bucketCount;
+}
+
+std::size_t TranspositionTable::getSlotCount() const {
+	return bucketCount * BUCKET_SLOTS;
+}
+
+std::size_t TranspositionTable::getSizeBytes() const {
+	return bucketCount * sizeof(Bucket);
+}
+
+// return the counters (each one read atomically, not all of them at once)
+TranspositionStats TranspositionTable::getStats() const {
+	TranspositionStats stats;
+	stats.hits = hits.value.load(std::memory_order_relaxed);
+	stats.misses = misses.value.load(std::memory_order_relaxed);
+	stats.stores = stores.value.load(std::memory_order_relaxed);
+	stats.collisions = collisions.value.load(std::memory_order_relaxed);
+	stats.rejected = rejected.value.load(std::memory_order_relaxed);
+	return stats;
+}
+
+// zero the counters
+void TranspositionTable::resetStats() {
+	for (Counter* counter : { &hits, &misses, &stores, &collisions, &rejected }) {
+		counter->value.store(0, std::memory_order_relaxed);
+	}
+}
+
+// return the fraction of the slots in use (a scan of the whole table)
+double TranspositionTable::getOccupancy() const {
+	std::size_t used = 0;
+	for (std::size_t i = 0; i < bucketCount; i++) {
+		for (const Slot& slot : buckets[i].slots) {
+			used += slot.data.load(std::memory_order_relaxed) != 0;
+		}
+	}
+	return static_cast<double>(used) / static_cast<double>(getSlotCount());
+}
+
+// return entry packed into a data word (never 0) / a data word unpacked
+std::uint64_t TranspositionTable::pack(const TranspositionEntry& entry) {
+	assert(entry.best.x + LOC_OFFSET >= 0 && entry.best.x + LOC_OFFSET < 64);
+	assert(entry.best.y + LOC_OFFSET >= 0 && entry.best.y + LOC_OFFSET < 64);
+	std::uint32_t scoreBits;
+	std::memcpy(&scoreBits, &entry.score, sizeof(scoreBits));
+	std::uint64_t depth = static_cast<std::uint64_t>(std::min(std::max(entry.depth, 0), MAX_DEPTH));
+	return scoreBits
+		| depth << DEPTH_SHIFT
+		| static_cast<std::uint64_t>(entry.best.shape & 0xF) << SHAPE_SHIFT
+		| static_cast<std::uint64_t>(entry.best.rotation & 0x3) << ROTATION_SHIFT
+		| static_cast<std::uint64_t>((entry.best.x + LOC_OFFSET) & 0x3F) << X_SHIFT
+		| static_cast<std::uint64_t>((entry.best.y + LOC_OFFSET) & 0x3F) << Y_SHIFT
+		| USED_BIT;
+}
+
+TranspositionEntry TranspositionTable::unpack(std::uint64_t data) {
+	TranspositionEntry entry;
+	std::uint32_t scoreBits = static_cast<std::uint32_t>(data);
+	std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+	entry.depth = getDepth(data);
+	entry.best.shape = static_cast<std::uint8_t>((data >> SHAPE_SHIFT) & 0xF);
+	entry.best.rotation = static_cast<std::uint8_t>((data >> ROTATION_SHIFT) & 0x3);
+	entry.best.x = static_cast<std::int8_t>(static_cast<int>((data >> X_SHIFT) & 0x3F) - LOC_OFFSET);
+	entry.best.y = static_cast<std::int8_t>(static_cast<int>((data >> Y_SHIFT) & 0x3F) - LOC_OFFSET);
+	return entry;
+}
+
+// return the depth of a data word
+int TranspositionTable::getDepth(std::uint64_t data) {
+	return static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+}
+
+// return the bucket of key
+TranspositionTable::Bucket& TranspositionTable::getBucket(std::uint64_t key) const {
+	return buckets[key & (bucketCount - 1)];
+}
@@ -0,0 +1,136 @@
+// The TranspositionTable remembers what searches found out about positions (a board &
+// the shape to place on it), so a search that reaches a position again - on any thread -
+// can reuse the result instead of searching it over.
+// Functionality:
+//  - A fixed number of buckets (a power of 2, from the memory budget given), each one
+//    cache line of BUCKET_SLOTS slots. A position's key picks its bucket.
+//  - Lock-free: any # of threads probe & store at once. A slot is 2 atomic words, the
+//    entry packed into one (data) & the key XOR data in the other (check). They are
+//    written one after the other, so a reader may see half of a store (or of 2 racing
+//    stores): then check XOR data isn't the key & the slot reads as a miss - a torn
+//    entry is never returned. Replacing an entry is 2 plain stores, no locks or retry
+//    loops (2 racing stores to a slot may lose both: it is only a cache).
+//  - Replacement: a store into a bucket without the key (or a free slot) evicts the
+//    shallowest entry: always (REPLACE_ALWAYS), or only if the new entry is as deep
+//    (REPLACE_DEPTH_PREFERRED: the deeper search is kept, the new one is dropped).
+//  - Counters of hits, misses, stores, collisions (evictions of another position's
+//    entry) & rejected stores, with the occupancy: to size the table for a workload.
+//    The counters are relaxed atomics, padded apart to a cache line each.
+//
+//  [expected .cpp size: ~ 200 lines]
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "GridTetromino.h"
+
+// what a search found out about a position
+struct TranspositionEntry
+{
+	float score = 0.0f;		// the score of the best board reached (relative to the position)
+	int depth = 0;			// the # of shapes searched from the position (0..MAX_DEPTH)
+	PackedPiece best = {};	// the placement of its shape towards that board
+};
+
+// the counters of a table (since it was built, or since resetStats())
+struct TranspositionStats
+{
+	std::uint64_t hits = 0;			// probes that found their position
+	std::uint64_t misses = 0;		// probes that didn't
+	std::uint64_t stores = 0;		// entries written
+	std::uint64_t collisions = 0;	// ...of them, over another position's entry
+	std::uint64_t rejected = 0;		// stores dropped for a deeper entry (REPLACE_DEPTH_PREFERRED)
+};
+
+// which entries a store may replace
+enum ReplacementPolicy {
+	REPLACE_DEPTH_PREFERRED,	// only entries no deeper than the new one
+	REPLACE_ALWAYS				// any entry (the shallowest of a full bucket)
+};
+
+class TranspositionTable
+{
+public:
+	static const int BUCKET_SLOTS = 4;								// slots per bucket (one cache line)
+	static const int MAX_DEPTH = 255;								// the deepest depth kept (deeper is clamped)
+	static const std::size_t DEFAULT_SIZE = 16 * 1024 * 1024;		// bytes
+
+	// constructor, a table of (at most) sizeBytes bytes - at least one bucket - replacing
+	//   entries by policy
+	TranspositionTable(std::size_t sizeBytes = DEFAULT_SIZE, ReplacementPolicy policy = REPLACE_DEPTH_PREFERRED);
+
+	// return the key of a position: a board (its hash, eg: Gameboard::getOccupancyHash())
+	//   & the shape to place on it
+	static std::uint64_t getKey(std::uint64_t boardHash, TetShape shape);
+
+	// look key up: return true & set entry if its position is in the table (thread safe)
+	bool probe(std::uint64_t key, TranspositionEntry& entry);
+	// store entry for key's position (thread safe: see ReplacementPolicy)
+	void store(std::uint64_t key, const TranspositionEntry& entry);
+	// empty the table (not thread safe: no other thread may use it meanwhile)
+	void clear();
+
+	// return the replacement policy, the # of buckets, slots & bytes
+	ReplacementPolicy getPolicy() const;
+	std::size_t getBucketCount() const;
+	std::size_t getSlotCount() const;
+	std::size_t getSizeBytes() const;
+
+	// return the counters (each one read atomically, not all of them at once)
+	TranspositionStats getStats() const;
+	// zero the counters
+	void resetStats();
+	// return the fraction of the slots in use (a scan of the whole table)
+	double getOccupancy() const;
+
+private:
+	// one entry: data (the packed entry, 0 = free) & check (key XOR data)
+	struct Slot
+	{
+		std::atomic<std::uint64_t> check;
+		std::atomic<std::uint64_t> data;
+	};
+	// the slots of one bucket (one cache line)
+	struct alignas(64) Bucket
+	{
+		Slot slots[BUCKET_SLOTS];
+	};
+	// a counter padded to a cache line: no 2 counters share one (threads bump them all
+	//   the time)
+	struct Counter
+	{
+		std::atomic<std::uint64_t> value;
+		char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+	// return entry packed into a data word (never 0) / a data word unpacked
+	static std::uint64_t pack(const TranspositionEntry& entry);
+	static TranspositionEntry unpack(std::uint64_t data);
+	// return the depth of a data word
+	static int getDepth(std::uint64_t data);
+
+	// return the bucket of key
+	Bucket& getBucket(std::uint64_t key) const;
+
+	// MEMBER VARIABLES
+	ReplacementPolicy policy;					// which entries a store may replace
+	std::size_t bucketCount;					// the # of buckets (a power of 2)
+	std::unique_ptr<unsigned char[]> memory;	// the buckets (& room to align them)
+	Bucket* buckets;							// the buckets, aligned to a cache line
+
+	Counter hits;
+	Counter misses;
+	Counter stores;
+	Counter collisions;
+	Counter rejected;
+
+	// FRIENDS
+	// for testing purposes (allows TestSuite to access private members of this class)
+	friend class TestSuite;
+};
+
+#endif /* TRANSPOSITIONTABLE_H */